@@ -25,7 +25,8 @@ namespace fslib
             /// @param directoryPath Path to directory as either FsLib::Path or UTF-16 formatted string. Ex: u"sdmc:/"
             /// @param sortEntries Optional. Whether or not entries should be sorted Dir->File, then alphabetically. This is
             /// done by default.
-            Directory(const fslib::Path &directoryPath, bool sortEntries = true);
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            Directory(const fslib::Path &directoryPath, bool sortEntries = true, bool naturalSort = false);
 
             /// @brief Move constructor.
             Directory(Directory &&directory);
@@ -41,7 +42,8 @@ namespace fslib
             /// successful.
             /// @param directoryPath Path to directory as either FsLib::Path or UTF-16 formatted string. Ex: u"sdmc:/"
             /// @param sortEntries Optional. Whether or not entries should be sorted Dir->File, then alphabetically.
-            void open(const fslib::Path &directoryPath, bool sortEntries = true);
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            void open(const fslib::Path &directoryPath, bool sortEntries = true, bool naturalSort = false);
 
             /// @brief Returns whether or not opening the directory and reading its contents was successful.
             /// @return True on success. False on failure.
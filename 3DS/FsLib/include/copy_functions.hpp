@@ -0,0 +1,46 @@
+#pragma once
+#include "Path.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fslib
+{
+    /// @brief Options for copying.
+    struct CopyOptions
+    {
+            /// @brief Size of each buffer passed between the reading and writing threads. This is at least 0x1000 bytes.
+            size_t bufferSize = 0x100000;
+
+            /// @brief Number of buffers that can be in flight at once. This is at least two.
+            int bufferCount = 4;
+    };
+
+    /// @brief Numbers reported after a copy.
+    struct CopyStats
+    {
+            /// @brief Total number of bytes copied.
+            uint64_t bytesCopied;
+
+            /// @brief How long the copy took in nanoseconds.
+            uint64_t nanoseconds;
+
+            /// @brief Average throughput of the copy.
+            double bytesPerSecond;
+    };
+
+    /**
+     * @brief Copies the file at source to destination. Reading and writing are done on separate threads so they overlap.
+     *
+     * @param source Path of the file to copy.
+     * @param destination Path to copy the file to. This is created and allocated to the source's size up front.
+     * @param options Optional. Buffer size and count to use.
+     * @param statsOut Optional. Pointer to write the numbers from the copy to.
+     * @return True on success. False on failure.
+     * @note Buffers are pooled and reused between copies.
+     */
+    bool copy_file(const fslib::Path &source,
+                   const fslib::Path &destination,
+                   const fslib::CopyOptions &options = {},
+                   fslib::CopyStats *statsOut        = nullptr);
+} // namespace fslib
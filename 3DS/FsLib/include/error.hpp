@@ -8,11 +8,16 @@ namespace fslib
 {
     namespace error
     {
-        /// @brief Returns the internal error string.
+        /// @brief Returns the error string for the last error recorded by the calling thread.
+        /// @note The string is built the first time this is called after an error. It belongs to the calling thread and is
+        /// overwritten the next time that thread records an error.
         const char *get_string();
 
-        /// @brief Returns whether or not an error occurred while using a libctru function. If so, it's recorded to the internal
-        /// error string.
+        /// @brief Returns the code of the last error recorded by the calling thread. 0 if there hasn't been one.
+        uint32_t get_code();
+
+        /// @brief Returns whether or not an error occurred while using a libctru function. If so, it's recorded for the calling
+        /// thread.
         /// @param code Code to check.
         bool libctru(Result code, const std::source_location &location = std::source_location::current());
 
@@ -3,6 +3,7 @@
 #include "DirectoryIterator.hpp"
 #include "File.hpp"
 #include "Path.hpp"
+#include "copy_functions.hpp"
 #include "dev.hpp"
 #include "directory_functions.hpp"
 #include "error.hpp"
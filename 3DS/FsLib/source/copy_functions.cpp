@@ -0,0 +1,170 @@
+#include "fslib.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Anything less than this and the threads just take turns.
+    constexpr int MINIMUM_BUFFER_COUNT = 2;
+
+    // Smallest buffer used. Zero would never read anything and tiny buffers are all service call overhead.
+    constexpr size_t MINIMUM_BUFFER_SIZE = 0x1000;
+
+    // Most buffers the pool will hold onto between copies.
+    constexpr size_t MAXIMUM_POOLED_BUFFERS = 16;
+
+    // A buffer passed from the reading thread to the writing thread.
+    typedef struct
+    {
+            std::unique_ptr<unsigned char[]> data;
+            size_t size;
+    } CopyChunk;
+
+    // Buffers kept between copies so they don't need to be allocated every time.
+    std::mutex s_poolLock{};
+    size_t s_pooledSize{};
+    std::vector<std::unique_ptr<unsigned char[]>> s_bufferPool{};
+} // namespace
+
+// Defined at bottom.
+static std::unique_ptr<unsigned char[]> acquire_buffer(size_t bufferSize);
+static void release_buffer(std::unique_ptr<unsigned char[]> buffer, size_t bufferSize);
+
+bool fslib::copy_file(const fslib::Path &source,
+                      const fslib::Path &destination,
+                      const fslib::CopyOptions &options,
+                      fslib::CopyStats *statsOut)
+{
+    const auto copyBegin = std::chrono::steady_clock::now();
+
+    fslib::File sourceFile{source, FS_OPEN_READ};
+    if (!sourceFile.is_open()) { return false; }
+
+    const uint64_t sourceSize = sourceFile.get_size();
+    fslib::File destinationFile{destination, FS_OPEN_CREATE | FS_OPEN_WRITE, sourceSize};
+    if (!destinationFile.is_open()) { return false; }
+
+    const size_t bufferSize = options.bufferSize < MINIMUM_BUFFER_SIZE ? MINIMUM_BUFFER_SIZE : options.bufferSize;
+    const int bufferCount   = options.bufferCount < MINIMUM_BUFFER_COUNT ? MINIMUM_BUFFER_COUNT : options.bufferCount;
+
+    std::mutex queueLock{};
+    std::condition_variable queueCondition{};
+    std::deque<CopyChunk> chunkQueue{};
+    int buffersInFlight{};
+    bool readingDone{};
+    bool copyFailed{};
+    uint64_t bytesWritten{};
+
+    // The writing thread. Reading stays on this one.
+    std::thread writeThread([&]() {
+        while (true)
+        {
+            CopyChunk chunk{};
+            {
+                std::unique_lock<std::mutex> queueGuard{queueLock};
+                queueCondition.wait(queueGuard, [&]() { return !chunkQueue.empty() || readingDone || copyFailed; });
+                if (chunkQueue.empty() || copyFailed) { return; }
+
+                chunk = std::move(chunkQueue.front());
+                chunkQueue.pop_front();
+            }
+
+            const bool writeError = destinationFile.write(chunk.data.get(), chunk.size) != static_cast<ssize_t>(chunk.size);
+            release_buffer(std::move(chunk.data), bufferSize);
+
+            {
+                std::lock_guard<std::mutex> queueGuard{queueLock};
+                --buffersInFlight;
+                if (writeError) { copyFailed = true; }
+                else { bytesWritten += chunk.size; }
+            }
+            queueCondition.notify_all();
+        }
+    });
+
+    uint64_t bytesRead{};
+    while (bytesRead < sourceSize)
+    {
+        {
+            std::unique_lock<std::mutex> queueGuard{queueLock};
+            queueCondition.wait(queueGuard, [&]() { return buffersInFlight < bufferCount || copyFailed; });
+            if (copyFailed) { break; }
+        }
+
+        CopyChunk chunk{acquire_buffer(bufferSize), 0};
+        const ssize_t readCount = sourceFile.read(chunk.data.get(), bufferSize);
+        if (readCount <= 0)
+        {
+            release_buffer(std::move(chunk.data), bufferSize);
+            std::lock_guard<std::mutex> queueGuard{queueLock};
+            copyFailed = true;
+            break;
+        }
+        chunk.size = readCount;
+        bytesRead += readCount;
+
+        {
+            std::lock_guard<std::mutex> queueGuard{queueLock};
+            chunkQueue.push_back(std::move(chunk));
+            ++buffersInFlight;
+        }
+        queueCondition.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> queueGuard{queueLock};
+        readingDone = true;
+    }
+    queueCondition.notify_all();
+    writeThread.join();
+
+    // Anything left behind after a failure still goes back to the pool.
+    for (CopyChunk &chunk : chunkQueue) { release_buffer(std::move(chunk.data), bufferSize); }
+    if (copyFailed) { return false; }
+
+    const auto copyEnd = std::chrono::steady_clock::now();
+    if (statsOut)
+    {
+        const auto copyTime      = std::chrono::duration_cast<std::chrono::nanoseconds>(copyEnd - copyBegin);
+        const double seconds     = static_cast<double>(copyTime.count()) / 1000000000.0;
+        statsOut->bytesCopied    = bytesWritten;
+        statsOut->nanoseconds    = copyTime.count();
+        statsOut->bytesPerSecond = seconds > 0.0 ? static_cast<double>(bytesWritten) / seconds : 0.0;
+    }
+
+    return true;
+}
+
+static std::unique_ptr<unsigned char[]> acquire_buffer(size_t bufferSize)
+{
+    {
+        std::lock_guard<std::mutex> poolGuard{s_poolLock};
+        if (s_pooledSize == bufferSize && !s_bufferPool.empty())
+        {
+            std::unique_ptr<unsigned char[]> buffer = std::move(s_bufferPool.back());
+            s_bufferPool.pop_back();
+            return buffer;
+        }
+    }
+    return std::make_unique<unsigned char[]>(bufferSize);
+}
+
+static void release_buffer(std::unique_ptr<unsigned char[]> buffer, size_t bufferSize)
+{
+    std::lock_guard<std::mutex> poolGuard{s_poolLock};
+
+    // The pool only holds one size at a time. The latest size wins.
+    if (s_pooledSize != bufferSize)
+    {
+        s_bufferPool.clear();
+        s_pooledSize = bufferSize;
+    }
+
+    if (s_bufferPool.size() < MAXIMUM_POOLED_BUFFERS) { s_bufferPool.push_back(std::move(buffer)); }
+}
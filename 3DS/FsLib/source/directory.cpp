@@ -6,10 +6,34 @@
 #include <cstring>
 #include <string>
 
-// Definition at bottom. Used to sort entries Dir->Alpha
-static bool compare_entries(const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB);
+namespace
+{
+    /// @brief Sort record. Keys are folded once into a single arena so comparisons don't redo the work.
+    typedef struct
+    {
+            /// @brief Offset of the key in the arena.
+            uint32_t offset;
+
+            /// @brief Length of the key.
+            uint32_t length;
 
-fslib::Directory::Directory(const fslib::Path &directoryPath, bool sortEntries) { Directory::open(directoryPath, sortEntries); }
+            /// @brief Index of the entry in the original list.
+            uint32_t index;
+
+            /// @brief Whether or not the entry is a directory.
+            bool isDirectory;
+    } SortRecord;
+} // namespace
+
+// Definitions at bottom. Used to sort entries Dir->Alpha
+static void sort_entries(std::vector<fslib::DirectoryEntry> &list, bool naturalSort);
+static int compare_keys(const char16_t *keyA, size_t lengthA, const char16_t *keyB, size_t lengthB);
+static int compare_keys_natural(const char16_t *keyA, size_t lengthA, const char16_t *keyB, size_t lengthB);
+
+fslib::Directory::Directory(const fslib::Path &directoryPath, bool sortEntries, bool naturalSort)
+{
+    Directory::open(directoryPath, sortEntries, naturalSort);
+}
 
 fslib::Directory::Directory(fslib::Directory &&directory) { *this = std::move(directory); }
 
@@ -26,7 +50,7 @@ fslib::Directory &fslib::Directory::operator=(fslib::Directory &&directory)
     return *this;
 }
 
-void fslib::Directory::open(const fslib::Path &directoryPath, bool sortEntries)
+void fslib::Directory::open(const fslib::Path &directoryPath, bool sortEntries, bool naturalSort)
 {
     m_wasOpened = false;
     m_list.clear();
@@ -44,7 +68,7 @@ void fslib::Directory::open(const fslib::Path &directoryPath, bool sortEntries)
     while (R_SUCCEEDED(FSDIR_Read(m_handle, &entriesRead, 1, &entry)) && entriesRead == 1) { m_list.emplace_back(entry); }
     Directory::close();
 
-    if (sortEntries) { std::sort(m_list.begin(), m_list.end(), compare_entries); }
+    if (sortEntries) { sort_entries(m_list, naturalSort); }
 }
 
 bool fslib::Directory::is_open() const { return m_wasOpened; }
@@ -67,22 +91,82 @@ bool fslib::Directory::close()
     return true;
 }
 
-static bool compare_entries(const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB)
+static void sort_entries(std::vector<fslib::DirectoryEntry> &list, bool naturalSort)
 {
-    const bool aIsDir = entryA.is_directory();
-    const bool bIsDir = entryB.is_directory();
-    if (aIsDir != bIsDir) { return aIsDir; }
-
-    const char16_t *nameA = entryA.get_filename();
-    const char16_t *nameB = entryB.get_filename();
-    const int lengthA     = std::char_traits<char16_t>::length(nameA);
-    const int lengthB     = std::char_traits<char16_t>::length(nameB);
-    const int shortest    = lengthA < lengthB ? lengthA : lengthB;
-    for (int i = 0; i < shortest; i++)
+    std::vector<char16_t> keyArena{};
+    std::vector<SortRecord> records{};
+    records.reserve(list.size());
+
+    const uint32_t listSize = list.size();
+    for (uint32_t i = 0; i < listSize; i++)
     {
-        const int charA = std::tolower(nameA[i]);
-        const int charB = std::tolower(nameB[i]);
-        if (charA != charB) { return charA < charB; }
+        const char16_t *filename = list[i].get_filename();
+        const uint32_t offset    = keyArena.size();
+        for (; *filename; filename++)
+        {
+            const char16_t character = *filename;
+            keyArena.push_back(character >= u'A' && character <= u'Z' ? character + (u'a' - u'A') : character);
+        }
+        records.push_back({offset, static_cast<uint32_t>(keyArena.size() - offset), i, list[i].is_directory()});
     }
-    return true;
+
+    const char16_t *keys = keyArena.data();
+    auto compareKeys     = naturalSort ? compare_keys_natural : compare_keys;
+    std::sort(records.begin(), records.end(), [&](const SortRecord &recordA, const SortRecord &recordB) {
+        if (recordA.isDirectory != recordB.isDirectory) { return recordA.isDirectory; }
+        return compareKeys(&keys[recordA.offset], recordA.length, &keys[recordB.offset], recordB.length) < 0;
+    });
+
+    std::vector<fslib::DirectoryEntry> sortedList{};
+    sortedList.reserve(listSize);
+    for (const SortRecord &record : records) { sortedList.push_back(std::move(list[record.index])); }
+    list = std::move(sortedList);
+}
+
+static int compare_keys(const char16_t *keyA, size_t lengthA, const char16_t *keyB, size_t lengthB)
+{
+    const size_t shortest = lengthA < lengthB ? lengthA : lengthB;
+    const int result      = std::char_traits<char16_t>::compare(keyA, keyB, shortest);
+    if (result != 0) { return result; }
+
+    return lengthA < lengthB ? -1 : lengthA > lengthB ? 1 : 0;
+}
+
+static int compare_keys_natural(const char16_t *keyA, size_t lengthA, const char16_t *keyB, size_t lengthB)
+{
+    auto isDigit = [](char16_t character) { return character >= u'0' && character <= u'9'; };
+
+    size_t a{}, b{};
+    while (a < lengthA && b < lengthB)
+    {
+        if (!isDigit(keyA[a]) || !isDigit(keyB[b]))
+        {
+            const char16_t charA = keyA[a++];
+            const char16_t charB = keyB[b++];
+            if (charA != charB) { return charA < charB ? -1 : 1; }
+            continue;
+        }
+
+        // Leading zeroes don't change the value. After that, the longer run is the bigger number.
+        while (a < lengthA && keyA[a] == u'0') { ++a; }
+        while (b < lengthB && keyB[b] == u'0') { ++b; }
+
+        size_t runEndA = a, runEndB = b;
+        while (runEndA < lengthA && isDigit(keyA[runEndA])) { ++runEndA; }
+        while (runEndB < lengthB && isDigit(keyB[runEndB])) { ++runEndB; }
+
+        const size_t digitsA = runEndA - a;
+        const size_t digitsB = runEndB - b;
+        if (digitsA != digitsB) { return digitsA < digitsB ? -1 : 1; }
+
+        const int result = std::char_traits<char16_t>::compare(&keyA[a], &keyB[b], digitsA);
+        if (result != 0) { return result; }
+
+        a = runEndA;
+        b = runEndB;
+    }
+
+    const size_t leftA = lengthA - a;
+    const size_t leftB = lengthB - b;
+    return leftA < leftB ? -1 : leftA > leftB ? 1 : 0;
 }
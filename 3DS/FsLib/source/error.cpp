@@ -1,47 +1,71 @@
 #include "error.hpp"
 
-#include "string.hpp"
-
-#include <string>
+#include <cstdio>
+#include <string_view>
 
 namespace
 {
-    std::string s_errorString = "No errors encountered.";
-}
+    // Buffer size for the formatted string. Anything past this is cut off.
+    constexpr int ERROR_BUFFER_SIZE = 0x200;
+
+    /// @brief The last error recorded by a thread. The string is only built from this when it's asked for.
+    struct ErrorState
+    {
+            /// @brief Code that was recorded.
+            uint32_t code{};
+
+            /// @brief Where the code was recorded.
+            std::source_location location{};
+
+            /// @brief Whether or not buffer is up to date with the code and location.
+            bool formatted = true;
+
+            /// @brief This is the error string.
+            char buffer[ERROR_BUFFER_SIZE] = "No errors encountered.";
+    };
+
+    /// @brief Each thread gets its own, so they can't overwrite each other's errors.
+    constinit thread_local ErrorState s_errorState{};
+} // namespace
 
 // Defined at bottom.
 static void prep_locations(const std::source_location &location, std::string_view &file, std::string_view &function);
 
-const char *fslib::error::get_string() { return s_errorString.c_str(); }
+// Defined at bottom.
+static void record(uint32_t code, const std::source_location &location);
 
-bool fslib::error::libctru(Result code, const std::source_location &location)
+const char *fslib::error::get_string()
 {
-    if (code == 0) { return false; }
+    if (s_errorState.formatted) { return s_errorState.buffer; }
 
+    const std::source_location &location = s_errorState.location;
     std::string_view filename{}, function{};
     prep_locations(location, filename, function);
-    s_errorString = string::get_formatted("%s::%s::%u::%u:%08X",
-                                          filename.data(),
-                                          function.data(),
-                                          location.line(),
-                                          location.column(),
-                                          code);
+    std::snprintf(s_errorState.buffer,
+                  ERROR_BUFFER_SIZE,
+                  "%s::%s::%u::%u:%08X",
+                  filename.data(),
+                  function.data(),
+                  static_cast<unsigned int>(location.line()),
+                  static_cast<unsigned int>(location.column()),
+                  static_cast<unsigned int>(s_errorState.code));
+    s_errorState.formatted = true;
 
-    return true;
+    return s_errorState.buffer;
 }
 
-void fslib::error::set_code(uint32_t code, const std::source_location &location)
+uint32_t fslib::error::get_code() { return s_errorState.code; }
+
+bool fslib::error::libctru(Result code, const std::source_location &location)
 {
-    std::string_view filename{}, function{};
-    prep_locations(location, filename, function);
-    s_errorString = string::get_formatted("%s::%s::%u::%u:%08X",
-                                          filename.data(),
-                                          function.data(),
-                                          location.line(),
-                                          location.column(),
-                                          code);
+    if (code == 0) { return false; }
+
+    record(code, location);
+    return true;
 }
 
+void fslib::error::set_code(uint32_t code, const std::source_location &location) { record(code, location); }
+
 static void prep_locations(const std::source_location &location, std::string_view &file, std::string_view &function)
 {
     file                   = location.file_name();
@@ -52,3 +76,11 @@ static void prep_locations(const std::source_location &location, std::string_vie
     const size_t functionBegin = function.find_first_of(' ');
     if (functionBegin != function.npos) { function = function.substr(functionBegin + 1); }
 }
+
+static void record(uint32_t code, const std::source_location &location)
+{
+    // Failures are expected for things like checking if a file exists, so this is all that's done until the string is needed.
+    s_errorState.code      = code;
+    s_errorState.location  = location;
+    s_errorState.formatted = false;
+}
@@ -4,37 +4,79 @@
 #include "string.hpp"
 
 #include <3ds.h>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string_view>
+#include <vector>
 
 namespace
 {
+    /// @brief A device name and the archive mapped to it. These are kept after the device is closed.
+    struct Device
+    {
+            /// @brief Archive mapped to the device.
+            std::atomic<FS_Archive> archive{};
+
+            /// @brief Whether or not an archive is mapped. This is set after the archive is written and cleared when it's closed.
+            std::atomic<bool> mapped{};
+    };
+
     // 3DS can use UTF-16 paths so that's what we're using.
-    std::map<std::u16string, FS_Archive, std::less<>> s_deviceMap{};
+    using DeviceTable = std::map<std::u16string, Device *, std::less<>>;
+
+    /// @brief Table lookups are done with. This is replaced instead of changed, so reading it never needs to lock.
+    std::atomic<const DeviceTable *> s_deviceTable{};
+
+    /// @brief Serializes mapping and closing devices.
+    std::mutex s_mountLock{};
+
+    /// @brief Owns every device record.
+    std::vector<std::unique_ptr<Device>> s_devices{};
+
+    /// @brief Owns every table that's been published. Readers can still be using an old one, so these are never freed. A new
+    /// table is only needed the first time a device name is used.
+    std::vector<std::unique_ptr<const DeviceTable>> s_deviceTables{};
 
     /// @brief This is reserved.
     constexpr std::u16string_view SDMC_DEVICE_NAME = u"sdmc";
 } // namespace
 
-// Checks if device is already in map.
-static inline bool device_is_in_use(std::u16string_view deviceName);
+// Returns the device if an archive is mapped to it. nullptr if there isn't.
+static Device *find_mapped(std::u16string_view deviceName);
+
+// Returns the device record for the name passed. Publishes a new table with it if needed. s_mountLock must be held.
+static Device &get_or_add_device(std::u16string_view deviceName);
 
 bool fslib::initialize()
 {
     const bool fsError = error::libctru(fsInit());
     if (fsError) { return false; }
 
-    const std::u16string sdmcDevice{SDMC_DEVICE_NAME};
-    FS_Archive &sdmc     = s_deviceMap[sdmcDevice];
+    std::lock_guard<std::mutex> mountGuard{s_mountLock};
+    FS_Archive sdmc{};
     const bool sdmcError = error::libctru(FSUSER_OpenArchive(&sdmc, ARCHIVE_SDMC, EMPTY_PATH));
     if (sdmcError) { return false; }
 
+    Device &device = get_or_add_device(SDMC_DEVICE_NAME);
+    device.archive.store(sdmc, std::memory_order_relaxed);
+    device.mapped.store(true, std::memory_order_release);
     return true;
 }
 
 void fslib::exit()
 {
-    for (auto &[deviceName, archive] : s_deviceMap) { FSUSER_CloseArchive(archive); }
+    {
+        std::lock_guard<std::mutex> mountGuard{s_mountLock};
+        for (auto &device : s_devices)
+        {
+            if (!device->mapped.exchange(false, std::memory_order_acq_rel)) { continue; }
+
+            FSUSER_CloseArchive(device->archive.load(std::memory_order_relaxed));
+        }
+    }
+
     fsExit();
 }
 
@@ -43,33 +85,37 @@ bool fslib::map_archive(std::u16string_view deviceName, FS_Archive archive)
     const bool sdGuard = deviceName == SDMC_DEVICE_NAME;
     if (sdGuard) { return false; }
 
-    const bool isInUse = device_is_in_use(deviceName);
-    if (isInUse) { fslib::close_device(deviceName); }
+    std::lock_guard<std::mutex> mountGuard{s_mountLock};
+    Device &device = get_or_add_device(deviceName);
 
-    const std::u16string device{deviceName};
-    s_deviceMap[device] = archive;
+    // Whatever was mapped here before is replaced.
+    const bool isInUse = device.mapped.exchange(false, std::memory_order_acq_rel);
+    if (isInUse) { FSUSER_CloseArchive(device.archive.load(std::memory_order_relaxed)); }
+
+    device.archive.store(archive, std::memory_order_relaxed);
+    device.mapped.store(true, std::memory_order_release);
     return true;
 }
 
 bool fslib::get_archive_by_device_name(std::u16string_view deviceName, FS_Archive &archiveOut)
 {
-    if (!device_is_in_use(deviceName))
+    Device *device = find_mapped(deviceName);
+    if (!device)
     {
         fslib::error::set_code(fslib::error::codes::DEVICE_NOT_FOUND);
         return false;
     }
 
-    const std::u16string device{deviceName};
-    archiveOut = s_deviceMap[device];
+    archiveOut = device->archive.load(std::memory_order_relaxed);
     return true;
 }
 
 bool fslib::control_device(std::u16string_view deviceName)
 {
-    if (!device_is_in_use(deviceName)) { return false; }
+    Device *device = find_mapped(deviceName);
+    if (!device) { return false; }
 
-    const std::u16string device{deviceName};
-    FS_Archive archive = s_deviceMap[device];
+    FS_Archive archive = device->archive.load(std::memory_order_relaxed);
     const bool error = error::libctru(FSUSER_ControlArchive(archive, ARCHIVE_ACTION_COMMIT_SAVE_DATA, nullptr, 0, nullptr, 0));
     if (error) { return false; }
 
@@ -78,18 +124,47 @@ bool fslib::control_device(std::u16string_view deviceName)
 
 bool fslib::close_device(std::u16string_view deviceName)
 {
-    if (!device_is_in_use(deviceName)) { return false; }
+    std::lock_guard<std::mutex> mountGuard{s_mountLock};
+    Device *device = find_mapped(deviceName);
+    if (!device) { return false; }
 
-    const std::u16string device{deviceName};
-    FS_Archive archive    = s_deviceMap[device];
+    FS_Archive archive    = device->archive.load(std::memory_order_relaxed);
     const bool closeError = error::libctru(FSUSER_CloseArchive(archive));
     if (closeError) { return false; }
 
-    s_deviceMap.erase(device);
+    device->mapped.store(false, std::memory_order_release);
     return true;
 }
 
-static inline bool device_is_in_use(std::u16string_view deviceName)
+static Device *find_mapped(std::u16string_view deviceName)
+{
+    const DeviceTable *deviceTable = s_deviceTable.load(std::memory_order_acquire);
+    if (!deviceTable) { return nullptr; }
+
+    const auto findDevice = deviceTable->find(deviceName);
+    if (findDevice == deviceTable->end()) { return nullptr; }
+
+    Device *device = findDevice->second;
+    return device->mapped.load(std::memory_order_acquire) ? device : nullptr;
+}
+
+static Device &get_or_add_device(std::u16string_view deviceName)
 {
-    return s_deviceMap.find(deviceName) != s_deviceMap.end();
+    const DeviceTable *deviceTable = s_deviceTable.load(std::memory_order_relaxed);
+    if (deviceTable)
+    {
+        const auto findDevice = deviceTable->find(deviceName);
+        if (findDevice != deviceTable->end()) { return *findDevice->second; }
+    }
+
+    // Copy the current table, add the new device and swap it in. Readers see either the old table or the new one.
+    auto newTable = deviceTable ? std::make_unique<DeviceTable>(*deviceTable) : std::make_unique<DeviceTable>();
+
+    Device &device = *s_devices.emplace_back(std::make_unique<Device>());
+    newTable->try_emplace(std::u16string{deviceName}, &device);
+
+    s_deviceTable.store(newTable.get(), std::memory_order_release);
+    s_deviceTables.push_back(std::move(newTable));
+
+    return device;
 }
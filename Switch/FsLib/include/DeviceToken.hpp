@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <switch.h>
+
+namespace fslib
+{
+    /// @brief A device that's already been looked up. Paths keep one of these so the device map is only searched once instead
+    /// of for every operation.
+    struct DeviceToken
+    {
+            /// @brief File system the device was mapped to when the token was made.
+            FsFileSystem *filesystem = nullptr;
+
+            /// @brief Generation counter of the device. This changes every time the device is mapped or closed.
+            const std::atomic<uint32_t> *generation = nullptr;
+
+            /// @brief Value of the counter when the token was made.
+            uint32_t mountGeneration = 0;
+
+            /// @brief Returns whether or not the device is still mapped to the same file system it was when the token was made.
+            bool is_current() const noexcept
+            {
+                return generation && generation->load(std::memory_order_acquire) == mountGeneration;
+            }
+    };
+
+    /// @brief Looks up the device passed and creates a token for it.
+    /// @param deviceName Name of the device.
+    /// @param tokenOut Token to write to. This is cleared if the device isn't mapped.
+    /// @return True if the device is mapped. False if it isn't.
+    bool resolve_device(std::string_view deviceName, fslib::DeviceToken &tokenOut);
+} // namespace fslib
@@ -1,12 +1,15 @@
 #pragma once
 #include "DirectoryEntry.hpp"
-#include "Path.hpp"
+#include "DirectoryReader.hpp"
+#include "PathView.hpp"
 
 #include <switch.h>
 #include <vector>
 
 namespace fslib
 {
+    // This is needed for the friend declaration.
+    class DirectoryView;
 
     /// @brief Class for opening and reading entries from directories.
     class Directory final
@@ -21,7 +24,19 @@ namespace fslib
             /// @param directoryPath Path to directory.
             /// @param sortListing Optional. Whether or not the listing is sorted Directories->Files and then alphabetically.
             /// This is done by default.
-            Directory(const fslib::Path &directoryPath, bool sortListing = true);
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            Directory(const fslib::PathView &directoryPath, bool sortListing = true, bool naturalSort = false);
+
+            /// @brief Attempts to open Directory path and read the entries that pass filter. Entries that don't are never
+            /// stored.
+            /// @param directoryPath Path to directory.
+            /// @param filter Filter to apply while the directory is read.
+            /// @param sortListing Optional. Whether or not to sort the listing. This is done by default.
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            Directory(const fslib::PathView &directoryPath,
+                      const fslib::DirectoryFilter &filter,
+                      bool sortListing = true,
+                      bool naturalSort = false);
 
             /// @brief Move constructor for directory.
             /// @param directory Directory to move.
@@ -38,7 +53,19 @@ namespace fslib
             /// @brief Attempts to open Directory path and read all entries. IsOpen can be used to check if this was successful.
             /// @param directoryPath Path to directory.
             /// @param sortListing Optional. Whether or not to sort the listing. This is done by default.
-            void open(const fslib::Path &directoryPath, bool sortListing = true);
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            void open(const fslib::PathView &directoryPath, bool sortListing = true, bool naturalSort = false);
+
+            /// @brief Attempts to open Directory path and read the entries that pass filter. Entries that don't are never
+            /// stored.
+            /// @param directoryPath Path to directory.
+            /// @param filter Filter to apply while the directory is read.
+            /// @param sortListing Optional. Whether or not to sort the listing. This is done by default.
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            void open(const fslib::PathView &directoryPath,
+                      const fslib::DirectoryFilter &filter,
+                      bool sortListing = true,
+                      bool naturalSort = false);
 
             /// @brief Returns if directory was successfully opened.
             /// @return True if it was. False if it wasn't.
@@ -64,20 +91,32 @@ namespace fslib
             /// @brief Returns the end iterator.
             Directory::iterator end() const noexcept;
 
+            /// @brief Allows the paged view to sort parts of the listing in place.
+            friend class fslib::DirectoryView;
+
         private:
             /// @brief Saves whether or not the directory was successfully opened and read.
             bool m_wasRead{};
 
-            /// @brief Handle to the directory.
-            FsDir m_handle{};
-
             /// @brief Total number of entries read from the directory.
             int64_t m_entryCount{};
 
             /// @brief Entry vector.
             std::vector<fslib::DirectoryEntry> m_directoryList{};
 
-            /// @brief Closes directory handle. Directory is never kept open. Not needed outside of class.
-            void close() noexcept;
+            /// @brief Every entry's name, null terminated, back to back. Entries point into this.
+            std::vector<char> m_nameArena{};
+
+            /// @brief Lowercase copy of the name arena used as sort keys. This is only kept while sorting is possible.
+            std::vector<char> m_keyArena{};
+
+            /// @brief Whether or not the keys are compared with natural ordering.
+            bool m_naturalSort{};
+
+            /// @brief Builds the sort keys from the name arena.
+            void build_sort_keys();
+
+            /// @brief Returns whether entryA sorts before entryB. Directories->Files and then by key.
+            bool compare_entries(const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB) const noexcept;
     };
 } // namespace fslib
@@ -1,28 +1,27 @@
 #pragma once
-#include <string>
+#include <cstdint>
 #include <switch.h>
 
 namespace fslib
 {
+    // These are needed for the friend declarations.
+    class Directory;
+    class DirectoryView;
+
+    /// @brief Compact record for an entry read by Directory. The name is stored in the Directory's name arena, so entries are
+    /// only valid as long as the Directory they came from.
     class DirectoryEntry
     {
         public:
-            /// @brief Constructor.
-            /// @param entry Entry to copy.
-            DirectoryEntry(const FsDirectoryEntry &entry);
-
-            DirectoryEntry(DirectoryEntry &&entry) noexcept;
-            DirectoryEntry &operator=(DirectoryEntry &&entry) noexcept;
-
-            DirectoryEntry(const DirectoryEntry &)            = delete;
-            DirectoryEntry &operator=(const DirectoryEntry &) = delete;
-
             /// @brief Returns whether or not the entry is a directory.
             bool is_directory() const noexcept;
 
             /// @brief Returns the file's name.
             const char *get_filename() const noexcept;
 
+            /// @brief Returns the length of the file's name.
+            size_t get_filename_length() const noexcept;
+
             /// @brief Returns the extension of the file.
             const char *get_extension() const noexcept;
 
@@ -30,13 +29,29 @@ namespace fslib
             int64_t get_size() const noexcept;
 
         private:
-            /// @brief Whether or not the entry is a directory.
-            bool m_directory{};
+            /// @brief Only Directory and DirectoryView can create these.
+            friend class fslib::Directory;
+            friend class fslib::DirectoryView;
 
-            /// @brief The entry's name.
-            std::string m_filename{};
+            /// @brief Constructor. The arena pointer is set by Directory once reading is finished.
+            /// @param entry Entry to take the type and size from.
+            /// @param nameOffset Offset of the entry's name in the arena.
+            /// @param nameLength Length of the entry's name.
+            DirectoryEntry(const FsDirectoryEntry &entry, uint32_t nameOffset, uint32_t nameLength) noexcept;
+
+            /// @brief Pointer to the name arena of the owning Directory.
+            const char *m_nameArena{};
 
             /// @brief The entry's size.
             int64_t m_size{};
+
+            /// @brief Offset of the entry's name in the arena.
+            uint32_t m_nameOffset{};
+
+            /// @brief Length of the entry's name.
+            uint16_t m_nameLength{};
+
+            /// @brief Whether or not the entry is a directory.
+            bool m_directory{};
     };
 }
@@ -0,0 +1,119 @@
+#pragma once
+#include "PathView.hpp"
+#include "stats.hpp"
+
+#include <memory>
+#include <string>
+#include <switch.h>
+
+namespace fslib
+{
+    /// @brief Filter applied while a directory is read. Entries that don't pass are dropped before anything is done with them.
+    struct DirectoryFilter
+    {
+            /// @brief Whether or not directories are read. This maps to the native open flags.
+            bool directories = true;
+
+            /// @brief Whether or not files are read. This maps to the native open flags.
+            bool files = true;
+
+            /// @brief Pattern names must match. * matches any run of characters and ? matches one. Matching ignores case.
+            /// Empty matches everything. Ex: "*.sav"
+            std::string pattern{};
+    };
+
+    /// @brief Reads the entries of a directory a batch at a time so memory use doesn't grow with the directory's size.
+    class DirectoryReader final
+    {
+        public:
+            /// @brief Default number of entries read per batch.
+            static constexpr size_t DEFAULT_BUFFER_COUNT = 0x40;
+
+            /// @brief Default constructor.
+            DirectoryReader() = default;
+
+            /// @brief Opens the directory for reading. is_open() can be used to check if this was successful.
+            /// @param directoryPath Path of the directory to read.
+            /// @param bufferCount Optional. Number of entries to read per batch.
+            /// @param filter Optional. Filter to apply to entries as they're read.
+            DirectoryReader(const fslib::PathView &directoryPath,
+                            size_t bufferCount                   = DirectoryReader::DEFAULT_BUFFER_COUNT,
+                            const fslib::DirectoryFilter &filter = {});
+
+            DirectoryReader(DirectoryReader &&directoryReader) noexcept;
+            DirectoryReader &operator=(DirectoryReader &&directoryReader) noexcept;
+
+            DirectoryReader(const DirectoryReader &)            = delete;
+            DirectoryReader &operator=(const DirectoryReader &) = delete;
+
+            /// @brief Closes the directory handle.
+            ~DirectoryReader();
+
+            /// @brief Opens the directory for reading.
+            /// @param directoryPath Path of the directory to read.
+            /// @param bufferCount Optional. Number of entries to read per batch.
+            /// @param filter Optional. Filter to apply to entries as they're read.
+            void open(const fslib::PathView &directoryPath,
+                      size_t bufferCount                   = DirectoryReader::DEFAULT_BUFFER_COUNT,
+                      const fslib::DirectoryFilter &filter = {});
+
+            /// @brief Closes the directory handle. This is called in the destructor too.
+            void close() noexcept;
+
+            /// @brief Returns if the directory was opened successfully.
+            bool is_open() const noexcept;
+
+            /// @brief Reads the next batch of entries. The previous batch is overwritten. Entries that don't match the filter's
+            /// pattern are skipped, so a batch can hold fewer entries than the buffer does.
+            /// @return True if anything was read. False at the end of the directory or on failure. read_failed tells the two
+            /// apart.
+            bool read() noexcept;
+
+            /// @brief Returns whether or not the last call to read() stopped because of an error instead of the end of the
+            /// directory. This is kept after close() and cleared by open().
+            bool read_failed() const noexcept;
+
+            /// @brief Returns the number of entries in the current batch.
+            int64_t get_read_count() const noexcept;
+
+            /// @brief Gets the total number of entries in the directory without reading them. Only the filter's entry types are
+            /// counted. The pattern isn't applied.
+            /// @param countOut Int64_t to write the count to.
+            /// @return True on success. False on failure.
+            bool get_entry_count(int64_t &countOut) noexcept;
+
+            /// @brief Returns the entry at index in the current batch. No bounds checking is performed.
+            const FsDirectoryEntry &operator[](int index) const noexcept;
+
+            /// @brief Returns the beginning of the current batch.
+            const FsDirectoryEntry *begin() const noexcept;
+
+            /// @brief Returns the end of the current batch.
+            const FsDirectoryEntry *end() const noexcept;
+
+        private:
+            /// @brief Handle to the directory.
+            FsDir m_handle{};
+
+            /// @brief Whether or not the directory was opened.
+            bool m_isOpen{};
+
+            /// @brief Number of entries the buffer holds.
+            size_t m_bufferCount{};
+
+            /// @brief Number of entries read by the last call to read().
+            int64_t m_readCount{};
+
+            /// @brief Whether or not the last call to read() failed.
+            bool m_readFailed{};
+
+            /// @brief Entry buffer.
+            std::unique_ptr<FsDirectoryEntry[]> m_entryBuffer{};
+
+            /// @brief Pattern entries must match.
+            std::string m_pattern{};
+
+            /// @brief Stats for the directory's device. This is always nullptr if fslib is built without stats.
+            fslib::stats::Counters *m_stats{};
+    };
+} // namespace fslib
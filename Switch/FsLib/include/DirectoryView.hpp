@@ -0,0 +1,92 @@
+#pragma once
+#include "Directory.hpp"
+#include "PathView.hpp"
+
+#include <vector>
+
+namespace fslib
+{
+    /// @brief Paged, sorted view of a directory. Only the pages asked for are put in order, so the first page of a large
+    /// directory doesn't wait on the whole listing being sorted.
+    class DirectoryView final
+    {
+        public:
+            /// @brief Default constructor.
+            DirectoryView() = default;
+
+            /// @brief Gets the entry count for the directory. The listing itself isn't read until a page is loaded.
+            /// @param directoryPath Path to the directory.
+            /// @param pageSize Number of entries per page.
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            DirectoryView(const fslib::PathView &directoryPath, int pageSize, bool naturalSort = false);
+
+            DirectoryView(DirectoryView &&directoryView)            = default;
+            DirectoryView &operator=(DirectoryView &&directoryView) = default;
+
+            DirectoryView(const DirectoryView &)            = delete;
+            DirectoryView &operator=(const DirectoryView &) = delete;
+
+            /// @brief Gets the entry count for the directory. The listing itself isn't read until a page is loaded.
+            /// @param directoryPath Path to the directory.
+            /// @param pageSize Number of entries per page.
+            /// @param naturalSort Optional. Whether or not runs of digits are sorted by value so file2 comes before file10.
+            void open(const fslib::PathView &directoryPath, int pageSize, bool naturalSort = false);
+
+            /// @brief Returns whether or not the directory's entry count could be retrieved.
+            bool is_open() const noexcept;
+
+            /// @brief Returns the number of entries in the directory. Before the first page is loaded, this is the count reported
+            /// by the file system. Afterwards, it's the number of entries actually read.
+            int64_t get_count() const noexcept;
+
+            /// @brief Returns the number of entries per page.
+            int get_page_size() const noexcept;
+
+            /// @brief Returns the number of pages.
+            int get_page_count() const noexcept;
+
+            /// @brief Reads the listing if it hasn't been yet and sorts the page passed into place.
+            /// @param page Page to load.
+            /// @return True on success. False on failure or if page is out of bounds.
+            bool load_page(int page);
+
+            /// @brief Returns the entry at index, loading the page it's on if needed.
+            /// @note An empty entry is returned if the view isn't open, index is out of bounds or the page couldn't be loaded.
+            /// @param index Index of the entry.
+            const fslib::DirectoryEntry &get_entry(int index);
+
+            /// @brief Same as get_entry.
+            const fslib::DirectoryEntry &operator[](int index);
+
+        private:
+            /// @brief Path of the directory.
+            fslib::Path m_directoryPath{};
+
+            /// @brief Whether or not the view was opened.
+            bool m_isOpen{};
+
+            /// @brief Whether or not natural ordering is used.
+            bool m_naturalSort{};
+
+            /// @brief Entries per page.
+            int m_pageSize{};
+
+            /// @brief Number of entries in the directory.
+            int64_t m_entryCount{};
+
+            /// @brief Underlying listing. This is read unsorted the first time a page is loaded.
+            fslib::Directory m_directory{};
+
+            /// @brief Which pages have been sorted.
+            std::vector<bool> m_sortedPages{};
+
+            /// @brief Page boundaries the listing is partitioned at. Everything before a boundary sorts before everything after.
+            std::vector<bool> m_boundaries{};
+
+            /// @brief Reads the listing and builds the sort keys.
+            bool read_listing();
+
+            /// @brief Returns the entry handed out when there isn't a real one to return. Its name is an empty string.
+            static const fslib::DirectoryEntry &get_empty_entry() noexcept;
+    };
+} // namespace fslib
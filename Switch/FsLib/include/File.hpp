@@ -1,11 +1,17 @@
 #pragma once
-#include "Path.hpp"
+#include "PathView.hpp"
 #include "Stream.hpp"
 #include "error.hpp"
+#include "stats.hpp"
 
+#include <memory>
+#include <mutex>
+#include <string>
 #include <switch.h>
 
 /// @brief This is an added OpenMode flag for FsLib on Switch so File::Open knows for sure it's supposed to create the file.
+/// @note If the file already exists, it's truncated in place instead of being deleted and created again. This implies
+/// FsOpenMode_Write.
 static constexpr uint32_t FsOpenMode_Create = BIT(8);
 
 namespace fslib
@@ -14,6 +20,22 @@ namespace fslib
     class File final : public fslib::Stream
     {
         public:
+            /// @brief Default size of the internal read/write buffer.
+            static constexpr size_t DEFAULT_BUFFER_SIZE = 0x10000;
+
+            /// @brief How the file is grown when a write goes past the end of it.
+            enum class GrowthPolicy
+            {
+                /// @brief The file is resized to exactly what is needed for every write. This is the default.
+                EXACT,
+
+                /// @brief The file's size is doubled every time it needs to grow. Best for writing files of an unknown size.
+                GEOMETRIC,
+
+                /// @brief fileSize passed to open is the expected final size. The file is allocated to that size up front.
+                SIZE_HINT
+            };
+
             /// @brief Default file constructor.
             File() = default;
 
@@ -23,8 +45,16 @@ namespace fslib
              * @param filePath Path to file.
              * @param openFlags Flags from LibNX to use to open the file with.
              * @param fileSize Optional. Creates the file with a starting size defined.
+             * @param bufferSize Optional. Size of the internal read/write buffer. Passing 0 disables buffering.
+             * @param growthPolicy Optional. How the file is grown when writing past the end of it.
+             * @note Any policy other than EXACT can allocate more than is written. The file is trimmed to the real size on
+             * flush() and close().
              */
-            File(const fslib::Path &filePath, uint32_t openFlags, int64_t fileSize = 0) noexcept;
+            File(const fslib::PathView &filePath,
+                 uint32_t openFlags,
+                 int64_t fileSize                = 0,
+                 size_t bufferSize               = File::DEFAULT_BUFFER_SIZE,
+                 File::GrowthPolicy growthPolicy = File::GrowthPolicy::EXACT) noexcept;
 
             /// @brief Move constructor.
             /// @param file File to eviscerate.
@@ -45,9 +75,16 @@ namespace fslib
             /// @param filePath Path to file.
             /// @param openFlags Flags from LibNX to use to open the file with.
             /// @param fileSize Optional. Creates the file with a starting size defined.
-            void open(const fslib::Path &filePath, uint32_t openFlags, int64_t fileSize = 0) noexcept;
+            /// @param bufferSize Optional. Size of the internal read/write buffer. Passing 0 disables buffering.
+            /// @param growthPolicy Optional. How the file is grown when writing past the end of it.
+            void open(const fslib::PathView &filePath,
+                      uint32_t openFlags,
+                      int64_t fileSize                = 0,
+                      size_t bufferSize               = File::DEFAULT_BUFFER_SIZE,
+                      File::GrowthPolicy growthPolicy = File::GrowthPolicy::EXACT) noexcept;
 
-            /// @brief Closes file handle if needed. Destructor takes care of this for you normally.
+            /// @brief Flushes any buffered writes and closes file handle if needed. Destructor takes care of this for you
+            /// normally.
             void close() noexcept;
 
             /// @brief Returns if file was successfully opened.
@@ -72,10 +109,24 @@ namespace fslib
             /// @return Byte read.
             signed char get_byte() noexcept;
 
+            /**
+             * @brief Reads from the file at the offset passed without using or changing the current offset.
+             *
+             * @param offset Offset in the file to read from.
+             * @param buffer Buffer to read into.
+             * @param bufferSize Number of bytes to read.
+             * @return Number of bytes read. -1 on error.
+             * @note This is safe to call from multiple threads at once. It skips the internal buffer, so writes still sitting in
+             * it won't be seen until flush() is called.
+             */
+            ssize_t read_at(int64_t offset, void *buffer, uint64_t bufferSize) const noexcept;
+
             /// @brief Attempts to write Buffer of BufferSize bytes to file.
             /// @param buffer Buffer containing data.
             /// @param bufferSize Size of Buffer.
             /// @return Number of bytes (assumed to be) written to file. -1 on error.
+            /// @note Writes smaller than the internal buffer are held until the buffer is full or flush(), seek() or close() is
+            /// called.
             ssize_t write(const void *buffer, uint64_t bufferSize) noexcept;
 
             /// @brief Attempts to write a formatted string to file.
@@ -95,12 +146,24 @@ namespace fslib
             /// @param string String to write.
             File &operator<<(const std::string &string) noexcept;
 
+            /**
+             * @brief Writes to the file at the offset passed without using or changing the current offset.
+             *
+             * @param offset Offset in the file to write to.
+             * @param buffer Buffer containing data.
+             * @param bufferSize Size of the buffer.
+             * @return Number of bytes (assumed to be) written to file. -1 on error.
+             * @note This is safe to call from multiple threads at once, but not alongside the other reading and writing functions.
+             * It skips the internal buffer, so call flush() first if read() or write() were used before this.
+             */
+            ssize_t write_at(int64_t offset, const void *buffer, uint64_t bufferSize) noexcept;
+
             /// @brief Seeks to the given position in a file.
             /// @param offset Offset to seek to.
             /// @param origin Origin to seek from.
             void seek(int64_t offset, Stream::Origin origin) override;
 
-            /// @brief Flushes file.
+            /// @brief Writes out anything still sitting in the buffer, trims any extra space allocated and flushes file.
             bool flush() noexcept;
 
         private:
@@ -110,9 +173,73 @@ namespace fslib
             /// @brief Stores flags used to open file.
             uint32_t m_flags{};
 
-            /// @brief Private: Resizes file if Buffer is too large to fit in remaining space.
-            /// @param bufferSize Size of buffer.
-            bool resize_if_needed(int64_t bufferSize);
+            /// @brief Read/write buffer. This is only allocated the first time a buffered read or write is performed.
+            std::unique_ptr<unsigned char[]> m_buffer{};
+
+            /// @brief Size of the buffer requested at open.
+            size_t m_bufferSize{};
+
+            /// @brief Offset in the file the buffer begins at.
+            int64_t m_bufferOffset{};
+
+            /// @brief Number of valid bytes currently in the buffer.
+            size_t m_bufferFilled{};
+
+            /// @brief Whether the buffer holds writes that haven't made it to the file yet.
+            bool m_bufferDirty{};
+
+            /// @brief Actual size of the file on the device. This can trail m_streamSize while writes are buffered or be
+            /// larger than it when the growth policy allocates ahead.
+            int64_t m_fileSize{};
+
+            /// @brief Growth policy passed to open.
+            File::GrowthPolicy m_growthPolicy{};
+
+            /// @brief Expected final size of the file for GrowthPolicy::SIZE_HINT.
+            int64_t m_sizeHint{};
+
+            /// @brief Guards resizing the file so write_at can be called from multiple threads.
+            std::mutex m_resizeLock{};
+
+            /// @brief Cache key for the file's path. This is only set for files opened for writing.
+            std::string m_cacheKey{};
+
+            /// @brief Stats for the file's device. This is always nullptr if fslib is built without stats.
+            fslib::stats::Counters *m_stats{};
+
+            /// @brief Private: Opens the file at path and truncates it to fileSize, or creates it if it doesn't exist.
+            /// @param filesystem Filesystem the file is on.
+            /// @param path Path of the file on the filesystem.
+            /// @param openFlags Flags to open the file with. FsOpenMode_Create should already be stripped.
+            /// @param fileSize Size the file should be once opened.
+            bool open_for_create(FsFileSystem *filesystem, const char *path, uint32_t openFlags, int64_t fileSize) noexcept;
+
+            /// @brief Private: Refills the read buffer starting at the current offset.
+            bool fill_buffer() noexcept;
+
+            /// @brief Private: Writes out pending buffered writes if there are any.
+            bool flush_buffer() noexcept;
+
+            /// @brief Private: Drops whatever is in the read buffer so it's refilled on the next read.
+            inline void invalidate_buffer() noexcept { m_bufferFilled = 0; }
+
+            /// @brief Private: Returns the number of buffered bytes available at the current offset.
+            inline size_t buffer_available() const noexcept
+            {
+                if (m_bufferDirty) { return 0; }
+
+                const int64_t bufferEnd  = m_bufferOffset + static_cast<int64_t>(m_bufferFilled);
+                const bool offsetInRange = m_offset >= m_bufferOffset && m_offset < bufferEnd;
+                if (!offsetInRange) { return 0; }
+                return bufferEnd - m_offset;
+            }
+
+            /// @brief Private: Resizes file according to the growth policy if it's smaller than requiredSize.
+            /// @param requiredSize Size the file needs to be at least.
+            bool resize_if_needed(int64_t requiredSize);
+
+            /// @brief Private: Trims the file back down to the logical size if the growth policy allocated past it.
+            bool trim_to_size() noexcept;
 
             /// @brief Private: Returns if file has flag set to read.
             inline bool is_open_for_reading() const noexcept
@@ -1,17 +1,24 @@
 #pragma once
-#include "FileSystem.hpp"
+#include "DeviceToken.hpp"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <switch.h>
 #include <unordered_map>
+#include <vector>
 
+/// @brief Device registry. Lookups never lock. Mapping and closing devices are serialized.
 class FsLibCore final
 {
     public:
         /// @brief Constructor. Mounts the sdmc.
         FsLibCore();
 
+        /// @brief Closes everything that's still mapped.
+        ~FsLibCore();
+
         // None of these shenanigans.
         FsLibCore(const FsLibCore &)            = delete;
         FsLibCore &operator=(const FsLibCore &) = delete;
@@ -27,6 +34,9 @@ class FsLibCore final
         /// @brief Searchs the map for a device matching deviceName. Returns true on success.
         bool get_file_system_by_device_name(std::string_view deviceName, FsFileSystem **filesystem);
 
+        /// @brief Searches the map for a device matching deviceName and creates a token for it. Returns true on success.
+        bool resolve_device(std::string_view deviceName, fslib::DeviceToken &tokenOut);
+
         /// @brief Closes the filesystem matching device name (if it's found.)
         bool close_file_system(std::string_view deviceName);
 
@@ -45,9 +55,43 @@ class FsLibCore final
         };
         // clang-format on
 
+        /// @brief A device name and whatever is mapped to it. These are kept after the device is closed so tokens pointing to
+        /// their generation can always be checked.
+        struct Device
+        {
+                /// @brief File system mapped to the device. This never moves, so pointers to it stay valid between mounts.
+                FsFileSystem filesystem{};
+
+                /// @brief Odd while something is mapped. This is bumped every time the device is mapped or closed.
+                std::atomic<uint32_t> generation{};
+        };
+
+        /// @brief Table of every device name that's been mapped. Tables are never changed once they're published.
+        using DeviceTable =
+            std::unordered_map<std::string, FsLibCore::Device *, FsLibCore::StringViewHash, FsLibCore::StringViewEquals>;
+
         /// @brief Stores whether or not fslib successfully initialized.
         bool m_initialized{};
 
-        /// @brief Underlying device map.
-        std::unordered_map<std::string, FileSystem, FsLibCore::StringViewHash, FsLibCore::StringViewEquals> m_deviceMap{};
-};
\ No newline at end of file
+        /// @brief Table lookups are done with. This is replaced instead of changed.
+        std::atomic<const FsLibCore::DeviceTable *> m_deviceTable{};
+
+        /// @brief Serializes mapping and closing devices.
+        std::mutex m_mountLock{};
+
+        /// @brief Owns every device record.
+        std::vector<std::unique_ptr<FsLibCore::Device>> m_devices{};
+
+        /// @brief Owns every table that's been published.
+        /** @note Readers can still be using an old table after it's replaced, so these are only freed with the core. A new
+         * table is only needed the first time a device name is used, so there's one of these per name ever mapped.
+         */
+        std::vector<std::unique_ptr<const FsLibCore::DeviceTable>> m_deviceTables{};
+
+        /// @brief Returns the device if something is mapped to it. nullptr if it isn't.
+        FsLibCore::Device *find_mapped(std::string_view deviceName) const noexcept;
+
+        /// @brief Returns the device record for the name passed, publishing a new table with it if needed.
+        /// @note m_mountLock must be held.
+        FsLibCore::Device &get_or_add_device(std::string_view deviceName);
+};
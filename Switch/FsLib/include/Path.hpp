@@ -1,12 +1,17 @@
 #pragma once
+#include "DeviceToken.hpp"
 #include "DirectoryEntry.hpp"
 
 #include <array>
 #include <filesystem>
+#include <memory>
 #include <string>
 
 namespace fslib
 {
+    // This is needed for the conversion constructor.
+    class PathView;
+
     /// @brief Class to make working with the Switch's FS and it's odd rules much easier.
     class Path final
     {
@@ -20,7 +25,7 @@ namespace fslib
 
             /// @brief Move constructor for path.
             /// @param path Path to eviscerate.
-            Path(Path &&path);
+            Path(Path &&path) noexcept;
 
             /// @brief Constructor for path.
             /// @param path String to assign.
@@ -38,15 +43,18 @@ namespace fslib
             /// @param path Path to assign.
             Path(const std::filesystem::path &path);
 
+            /// @brief Constructor for path. This is explicit since it's the one conversion that allocates.
+            /// @param path View to copy.
+            explicit Path(const fslib::PathView &path);
+
             /**
              * @brief Return whether or not path is valid for use with FsLib and Switch's FS.
              *
              * @return True if it is. False if it's not.
-             * @note Based on four conditions:
-                    1. The path was properly allocated and m_Path isn't nullptr.
-                    2. There was a device found in the path.
-                    3. The path length following the device is not empty.
-                    4. The path has no illegal characters in it.
+             * @note Based on three conditions:
+                    1. There was a device found in the path.
+                    2. The path length following the device is not empty.
+                    3. The path has no illegal characters in it.
              */
             bool is_valid() const noexcept;
 
@@ -106,6 +114,9 @@ namespace fslib
             /// @note Trying to use .data() with this will just result in the entire path being returned.
             std::string_view get_device_name() const noexcept;
 
+            /// @brief Returns the token for the device the path was resolved to when it was assigned.
+            const fslib::DeviceToken &get_device_token() const noexcept;
+
             /// @brief Returns the path after the device for use with Switch's FS functions. Ex: /Path/To/File.txt
             const char *get_path() const noexcept;
 
@@ -124,7 +135,7 @@ namespace fslib
 
             /// @brief Move = operator.
             /// @param path Path to eviscerate.
-            Path &operator=(Path &&path);
+            Path &operator=(Path &&path) noexcept;
 
             /// @brief Assigns path
             /// @param path String to assign from.
@@ -140,7 +151,7 @@ namespace fslib
 
             /// @brief Assigns path from path passed.
             /// @param path Path to assign from.
-            Path &operator=(const std::filesystem::path &path);
+            Path &operator=(const std::filesystem::path &path) noexcept;
 
             /// @brief Appends path to Path.
             /// @param path String to append.
@@ -191,18 +202,43 @@ namespace fslib
             static constexpr uint16_t NOT_FOUND = -1;
 
         private:
+            /// @brief Paths shorter than this are stored inside of the Path instead of being allocated.
+            static constexpr size_t INLINE_PATH_SIZE = 0x80;
+
             /// @brief String containing the device string.
             std::string m_device{};
 
-            /// @brief Path buffer.
-            /** @note The Switch seems to only really like buffers 0x301 in length? Using STL containers with short
-             * paths can seemingly cause random errors for no reason?
+            /// @brief Device resolved when the path was assigned. Operations use this instead of searching for the device.
+            fslib::DeviceToken m_deviceToken{};
+
+            /// @brief Buffer used for short paths. Only what's used is ever written or copied.
+            char m_inlinePath[INLINE_PATH_SIZE];
+
+            /// @brief Buffer used once the path is too long for the inline one.
+            /** @note This is always FS_MAX_PATH in length. The Switch seems to only really like buffers 0x301 in length? Using
+             * STL containers with short paths can seemingly cause random errors for no reason? libnx copies the path into
+             * its own buffer that length before sending it, so the inline buffer is fine.
              */
-            std::unique_ptr<char[]> m_path{};
+            std::unique_ptr<char[]> m_heapPath{};
 
             /// @brief Current offset in the path.
             uint16_t m_offset{};
 
+            /// @brief Returns the buffer the path is currently in.
+            char *get_buffer() noexcept;
+
+            /// @brief Returns the buffer the path is currently in.
+            const char *get_buffer() const noexcept;
+
+            /// @brief Makes sure there's room for a path of the length passed.
+            /// @param length Length of the path not including the NULL terminator.
+            /// @note This only allocates if the path won't fit inline. The contents of the path are kept.
+            void reserve(size_t length);
+
+            /// @brief Copies the path passed. Only the length used is copied.
+            /// @param path Path to copy.
+            void copy_from(const Path &path);
+
             /// @brief Makes sure the path is null terminated.
             void null_terminate() noexcept;
     };
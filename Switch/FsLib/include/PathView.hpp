@@ -0,0 +1,101 @@
+#pragma once
+#include "Path.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <switch.h>
+
+namespace fslib
+{
+    /// @brief Non-owning view of a path. Every fslib function that takes a path takes one of these, so strings and literals
+    /// can be passed without a Path being allocated for them.
+    /// @note The view is only valid as long as the string it was created from. It's meant to be created for a call, not kept.
+    class PathView final
+    {
+        public:
+            /// @brief Buffer large enough to hold any path the Switch's FS accepts.
+            using Buffer = std::array<char, FS_MAX_PATH>;
+
+            /// @brief Default constructor. The view is empty and invalid.
+            PathView() = default;
+
+            /// @brief Creates a view of an existing Path.
+            /// @param path Path to view.
+            PathView(const fslib::Path &path) noexcept;
+
+            /// @brief Creates a view of a NULL terminated string.
+            /// @param path String to view. Ex: sdmc:/Path/To/File.txt
+            PathView(const char *path) noexcept;
+
+            /// @brief Creates a view of a string.
+            /// @param path String to view.
+            PathView(const std::string &path) noexcept;
+
+            /// @brief Creates a view of a string.
+            /// @param path String to view.
+            PathView(std::string_view path) noexcept;
+
+            /**
+             * @brief Returns whether or not the path is valid for use with FsLib and Switch's FS.
+             *
+             * @return True if it is. False if it's not.
+             * @note This is checked once when the view is created. Based on three conditions:
+                    1. There was a device found in the path.
+                    2. The path fits in FS_MAX_PATH.
+                    3. The path has no illegal characters in it.
+                A path without a slash after the device, like sdmc:file, is valid. The slash is added when it's copied out.
+             */
+            bool is_valid() const noexcept;
+
+            /// @brief Returns a view of the first pathLength characters of the path following the device.
+            /// @param pathLength Length of the sub-path to return.
+            PathView sub_path(size_t pathLength) const noexcept;
+
+            /// @brief Returns the device at the beginning of the path.
+            std::string_view get_device_name() const noexcept;
+
+            /// @brief Returns the token of the Path this is a view of. Views of strings have an empty one.
+            const fslib::DeviceToken &get_device_token() const noexcept;
+
+            /// @brief Returns the path after the device. Ex: /Path/To/File.txt. Leading slashes are collapsed to one and
+            /// trailing slashes are trimmed. This isn't guaranteed to be NULL terminated or to start with a slash. Use
+            /// get_path(Buffer) where the slash matters.
+            std::string_view get_path() const noexcept;
+
+            /// @brief Returns the path after the device NULL terminated and starting with a slash for use with Switch's FS
+            /// functions.
+            /// @param buffer Buffer the path is copied to if the view can't be used as is.
+            const char *get_path(PathView::Buffer &buffer) const noexcept;
+
+            /// @brief Returns the length of the path after the device. A missing slash isn't counted.
+            size_t get_length() const noexcept;
+
+            /// @brief Returns the entire path with a slash after the device. Ex: sdmc:/Path/To/File.txt
+            std::string string() const;
+
+        private:
+            /// @brief Device the path is on.
+            std::string_view m_device{};
+
+            /// @brief Path after the device.
+            std::string_view m_path{};
+
+            /// @brief Device token copied from the Path viewed. Strings aren't resolved, since that's the same search.
+            fslib::DeviceToken m_deviceToken{};
+
+            /// @brief Whether or not m_path is followed by a NULL terminator in memory.
+            bool m_terminated{};
+
+            /// @brief Whether or not the path was passed without a slash after the device. Ex: sdmc:file
+            bool m_missingSlash{};
+
+            /// @brief Whether or not the path passed the checks in is_valid.
+            bool m_valid{};
+
+            /// @brief Splits and checks a full path. Used by the string constructors.
+            /// @param path Full path to parse.
+            /// @param terminated Whether or not the string passed is followed by a NULL terminator.
+            void parse(std::string_view path, bool terminated) noexcept;
+    };
+} // namespace fslib
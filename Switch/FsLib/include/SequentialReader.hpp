@@ -0,0 +1,176 @@
+#pragma once
+#include "File.hpp"
+#include "Storage.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fslib
+{
+    /**
+     * @brief Reads a File or Storage from start to finish with reads kept in flight on a background thread.
+     *
+     * @note The File or Storage passed must outlive the reader. Reading starts at its current offset, but the offset is never
+     * changed. File's internal buffer is skipped, so anything written to it should be flushed first.
+     */
+    class SequentialReader final
+    {
+        public:
+            /// @brief Default size of each chunk read ahead.
+            static constexpr size_t DEFAULT_CHUNK_SIZE = 0x100000;
+
+            /// @brief Default number of chunks. One is held by the caller while the rest are read ahead.
+            static constexpr int DEFAULT_CHUNK_COUNT = 3;
+
+            /// @brief Default constructor.
+            SequentialReader() = default;
+
+            /// @brief Starts reading ahead from the file passed. is_open() can be used to check if this was successful.
+            /// @param file File to read from. This must be open for reading.
+            /// @param chunkSize Optional. Size of each chunk read. This is at least one byte.
+            /// @param chunkCount Optional. Number of chunks to allocate. This is at least two.
+            SequentialReader(const fslib::File &file,
+                             size_t chunkSize = SequentialReader::DEFAULT_CHUNK_SIZE,
+                             int chunkCount   = SequentialReader::DEFAULT_CHUNK_COUNT);
+
+            /// @brief Starts reading ahead from the storage passed. is_open() can be used to check if this was successful.
+            /// @param storage Storage to read from.
+            /// @param chunkSize Optional. Size of each chunk read. This is at least one byte.
+            /// @param chunkCount Optional. Number of chunks to allocate. This is at least two.
+            SequentialReader(const fslib::Storage &storage,
+                             size_t chunkSize = SequentialReader::DEFAULT_CHUNK_SIZE,
+                             int chunkCount   = SequentialReader::DEFAULT_CHUNK_COUNT);
+
+            // The thread holds a pointer to this. It can't be moved or copied.
+            SequentialReader(const SequentialReader &)            = delete;
+            SequentialReader(SequentialReader &&)                 = delete;
+            SequentialReader &operator=(const SequentialReader &) = delete;
+            SequentialReader &operator=(SequentialReader &&)      = delete;
+
+            /// @brief Stops the read ahead thread.
+            ~SequentialReader();
+
+            /// @brief Starts reading ahead from the file passed.
+            /// @param file File to read from. This must be open for reading.
+            /// @param chunkSize Optional. Size of each chunk read. This is at least one byte.
+            /// @param chunkCount Optional. Number of chunks to allocate. This is at least two.
+            void open(const fslib::File &file,
+                      size_t chunkSize = SequentialReader::DEFAULT_CHUNK_SIZE,
+                      int chunkCount   = SequentialReader::DEFAULT_CHUNK_COUNT);
+
+            /// @brief Starts reading ahead from the storage passed.
+            /// @param storage Storage to read from.
+            /// @param chunkSize Optional. Size of each chunk read. This is at least one byte.
+            /// @param chunkCount Optional. Number of chunks to allocate. This is at least two.
+            void open(const fslib::Storage &storage,
+                      size_t chunkSize = SequentialReader::DEFAULT_CHUNK_SIZE,
+                      int chunkCount   = SequentialReader::DEFAULT_CHUNK_COUNT);
+
+            /// @brief Stops the read ahead thread. The destructor takes care of this.
+            void close() noexcept;
+
+            /// @brief Returns whether or not the reader was started successfully.
+            bool is_open() const noexcept;
+
+            /**
+             * @brief Waits for the next chunk to be read and hands it over without copying.
+             *
+             * @param chunkOut Set to point to the chunk's data.
+             * @return Size of the chunk. 0 at the end. -1 on error.
+             * @note The chunk is only valid until the next call to next_chunk(), read() or close().
+             */
+            ssize_t next_chunk(const void **chunkOut);
+
+            /// @brief Copies the next bufferSize bytes into buffer.
+            /// @param buffer Buffer to copy to.
+            /// @param bufferSize Size of the buffer.
+            /// @return Number of bytes copied. -1 on error.
+            ssize_t read(void *buffer, uint64_t bufferSize);
+
+            /// @brief Returns the offset the caller has read up to.
+            int64_t tell() const noexcept;
+
+            /// @brief Returns the offset reading stops at.
+            int64_t get_size() const noexcept;
+
+            /// @brief Returns whether or not everything has been read.
+            bool end_of_stream() const noexcept;
+
+        private:
+            /// @brief A single chunk of data being read ahead.
+            typedef struct
+            {
+                    std::unique_ptr<unsigned char[]> data;
+                    ssize_t size;
+            } Chunk;
+
+            /// @brief File being read if one was passed.
+            const fslib::File *m_file{};
+
+            /// @brief Storage being read if one was passed.
+            const fslib::Storage *m_storage{};
+
+            /// @brief Whether or not the reader was started.
+            bool m_isOpen{};
+
+            /// @brief Chunk array.
+            std::unique_ptr<Chunk[]> m_chunks{};
+
+            /// @brief Size of each chunk.
+            size_t m_chunkSize{};
+
+            /// @brief Number of chunks.
+            int m_chunkCount{};
+
+            /// @brief Number of chunks read and not released by the caller yet. This includes the one being held.
+            int m_chunksReady{};
+
+            /// @brief Chunk the caller reads from next.
+            int m_readIndex{};
+
+            /// @brief Whether the caller is holding the chunk at m_readIndex.
+            bool m_holdingChunk{};
+
+            /// @brief Position in the held chunk read() has copied up to.
+            size_t m_chunkPosition{};
+
+            /// @brief Size of the held chunk.
+            size_t m_chunkLength{};
+
+            /// @brief Offset the caller has read up to.
+            int64_t m_offset{};
+
+            /// @brief Offset reading stops at.
+            int64_t m_endOffset{};
+
+            /// @brief Signals the thread to stop.
+            bool m_stop{};
+
+            /// @brief Protects the chunk counts.
+            std::mutex m_chunkLock{};
+
+            /// @brief Used to signal between the thread and caller.
+            std::condition_variable m_chunkCondition{};
+
+            /// @brief The read ahead thread.
+            std::thread m_thread{};
+
+            /// @brief Private: Allocates the chunks and spawns the thread.
+            /// @param startOffset Offset to start reading at.
+            /// @param endOffset Offset to stop reading at.
+            void start(int64_t startOffset, int64_t endOffset, size_t chunkSize, int chunkCount);
+
+            /// @brief Private: Waits for the next chunk and marks it as held without counting it as read.
+            /// @param chunkOut Set to point to the chunk's data.
+            ssize_t take_chunk(const void **chunkOut);
+
+            /// @brief Private: The function the read ahead thread runs.
+            /// @param startOffset Offset to start reading from.
+            void read_ahead(int64_t startOffset);
+
+            /// @brief Private: Reads from whichever source was passed.
+            ssize_t read_source(int64_t offset, void *buffer, size_t bufferSize) const;
+    };
+} // namespace fslib
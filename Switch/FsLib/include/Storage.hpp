@@ -47,6 +47,14 @@ namespace fslib
             /// @return Byte read on success. -1 on failure.
             signed char read_byte();
 
+            /// @brief Reads from storage at the offset passed without using or changing the current offset.
+            /// @param offset Offset to read from.
+            /// @param buffer Buffer to read into.
+            /// @param bufferSize Number of bytes to read.
+            /// @return Number of bytes read. -1 on failure.
+            /// @note This is safe to call from multiple threads at once.
+            ssize_t read_at(int64_t offset, void *buffer, size_t bufferSize) const;
+
         private:
             /// @brief Handle to storage opened.
             FsStorage m_storageHandle{};
@@ -0,0 +1,80 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Internal pool of worker threads. Each worker has its own queue and steals from the others when it runs dry.
+class WorkerPool final
+{
+    public:
+        /// @brief Work done by the pool.
+        using Task = std::function<void()>;
+
+        /// @brief Constructor. Starts the workers.
+        /// @param threadCount Number of worker threads to start. This is at least one.
+        WorkerPool(int threadCount);
+
+        // None of these shenanigans.
+        WorkerPool(const WorkerPool &)            = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+        WorkerPool(WorkerPool &&)                 = delete;
+        WorkerPool &operator=(WorkerPool &&)      = delete;
+
+        /// @brief Waits for everything queued to finish and stops the workers.
+        ~WorkerPool();
+
+        /// @brief Queues a task. Tasks are spread across the workers' queues in turn.
+        /// @param task Task to queue. This can be called from inside of a running task.
+        void push(WorkerPool::Task task);
+
+        /// @brief Blocks until every task queued, including ones queued by other tasks, has finished.
+        void wait();
+
+    private:
+        /// @brief A single worker's queue.
+        struct WorkerQueue
+        {
+                std::mutex lock;
+                std::deque<WorkerPool::Task> tasks;
+        };
+
+        /// @brief Worker queue array.
+        std::unique_ptr<WorkerQueue[]> m_queues{};
+
+        /// @brief Number of workers.
+        int m_threadCount{};
+
+        /// @brief Worker threads.
+        std::vector<std::thread> m_threads{};
+
+        /// @brief Queue the next task pushed goes to.
+        int m_nextQueue{};
+
+        /// @brief Protects the counts below.
+        std::mutex m_stateLock{};
+
+        /// @brief Signals when tasks are queued or finished.
+        std::condition_variable m_stateCondition{};
+
+        /// @brief Number of tasks sitting in queues.
+        int m_queued{};
+
+        /// @brief Number of tasks queued or running.
+        int m_pending{};
+
+        /// @brief Tells the workers to exit.
+        bool m_stop{};
+
+        /// @brief The function each worker runs.
+        /// @param index Index of the worker's own queue.
+        void worker(int index);
+
+        /// @brief Takes the newest task from the worker's own queue or the oldest one from another's.
+        /// @param index Index of the worker's own queue.
+        /// @param taskOut Task to write to.
+        bool take_task(int index, WorkerPool::Task &taskOut);
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "Directory.hpp"
+#include "PathView.hpp"
+
+#include <string>
+#include <string_view>
+#include <switch.h>
+
+/// @brief Internal caches of results fslib can answer without the file system. Not needed outside of fslib.
+
+namespace fslib
+{
+    namespace cache
+    {
+        /// @brief What's known about a path.
+        typedef struct
+        {
+                /// @brief Whether or not anything exists at the path.
+                bool exists;
+
+                /// @brief Type of the entry if it exists.
+                FsDirEntryType type;
+
+                /// @brief Size of the file. -1 if it isn't known.
+                int64_t size;
+        } Metadata;
+
+        /// @brief Returns the key used for path. This is the device and path joined with a colon.
+        std::string make_key(const fslib::PathView &path);
+
+        /// @brief Gets a cached directory size.
+        /// @param directoryPath Path of the directory.
+        /// @param sizeOut Int64_t to write the size to.
+        /// @return True if the size was cached. False if it wasn't.
+        bool get_directory_size(const fslib::PathView &directoryPath, int64_t &sizeOut);
+
+        /// @brief Caches the size of the directory passed.
+        void set_directory_size(const fslib::PathView &directoryPath, int64_t size);
+
+        /// @brief Drops every cached directory size.
+        void clear_directory_sizes();
+
+        /// @brief Returns whether or not the directory at key is known to exist. Directories are only known for devices with
+        /// the metadata cache on.
+        /// @param key Key made by make_key for the directory.
+        bool directory_known(std::string_view key);
+
+        /// @brief Records that the directory at key exists. Callers only do this for devices with the metadata cache on.
+        void add_known_directory(std::string_view key);
+
+        /// @brief Forgets every directory known to exist.
+        void clear_known_directories();
+
+        /// @brief Turns metadata caching on or off for a device. Everything cached for it is dropped either way.
+        /// @param ignoreCase Whether or not the device ignores case in names.
+        void set_metadata_enabled(std::string_view deviceName, bool enabled, bool ignoreCase);
+
+        /// @brief Returns whether or not metadata is cached for the device passed.
+        bool metadata_enabled(std::string_view deviceName);
+
+        /// @brief Gets what's known about path.
+        /// @param path Path to look up.
+        /// @param metadataOut Metadata to write to.
+        /// @return True if anything is known. False if the file system needs to be asked.
+        bool get_metadata(const fslib::PathView &path, cache::Metadata &metadataOut);
+
+        /// @brief Records what the file system said about path.
+        void set_metadata(const fslib::PathView &path, const cache::Metadata &metadata);
+
+        /// @brief Answers from the cache or asks the file system for the type of path and caches the answer.
+        /// @param filesystem File system the path is on.
+        /// @param path Path to look up.
+        /// @param metadataOut Metadata to write to.
+        /// @return True if the answer is known. False if the file system couldn't say.
+        bool query_metadata(FsFileSystem *filesystem, const fslib::PathView &path, cache::Metadata &metadataOut);
+
+        /// @brief Records every entry of a complete listing. Anything not in it is known not to exist.
+        void add_listing(const fslib::PathView &directoryPath, const fslib::Directory &directory);
+
+        /// @brief Drops everything cached for the device passed. This is called when a device is mapped or closed.
+        void clear_device(std::string_view deviceName);
+
+        /// @brief Called by fslib after it creates something.
+        void created(const fslib::PathView &path, FsDirEntryType type, int64_t size);
+
+        /// @brief Called by fslib after it deletes something.
+        /// @param recursive Whether or not everything under the path was deleted with it.
+        void removed(const fslib::PathView &path, bool recursive);
+
+        /// @brief Called by fslib after it renames something.
+        void renamed(const fslib::PathView &oldPath, const fslib::PathView &newPath, FsDirEntryType type);
+
+        /// @brief Called by File when a file opened for writing is opened and closed.
+        /// @param key Key made by make_key for the file.
+        /// @param size Size of the file. -1 if it isn't known yet.
+        void written(std::string_view key, int64_t size);
+    } // namespace cache
+} // namespace fslib
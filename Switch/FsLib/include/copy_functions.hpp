@@ -0,0 +1,71 @@
+#pragma once
+#include "PathView.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fslib
+{
+    /// @brief Options for copying.
+    struct CopyOptions
+    {
+            /// @brief Size of each buffer passed between the reading and writing threads. This is at least 0x1000 bytes.
+            size_t bufferSize = 0x100000;
+
+            /// @brief Number of buffers that can be in flight at once. This is at least two.
+            int bufferCount = 4;
+
+            /// @brief Number of worker threads copy_directory_recursively uses.
+            int threadCount = 4;
+
+            /// @brief Files this size or smaller are batched together by copy_directory_recursively.
+            int64_t smallFileSize = 0x20000;
+
+            /// @brief Files larger than this are split into pieces this size for copy_directory_recursively.
+            int64_t splitSize = 0x2000000;
+    };
+
+    /// @brief Numbers reported after a copy.
+    struct CopyStats
+    {
+            /// @brief Total number of bytes copied.
+            int64_t bytesCopied;
+
+            /// @brief How long the copy took in nanoseconds.
+            uint64_t nanoseconds;
+
+            /// @brief Average throughput of the copy.
+            double bytesPerSecond;
+    };
+
+    /**
+     * @brief Copies the file at source to destination. Reading and writing are done on separate threads so they overlap.
+     *
+     * @param source Path of the file to copy.
+     * @param destination Path to copy the file to. This is created or truncated and allocated to the source's size up front.
+     * @param options Optional. Buffer size and count to use.
+     * @param statsOut Optional. Pointer to write the numbers from the copy to.
+     * @return True on success. False on failure.
+     * @note Buffers are pooled and reused between copies.
+     */
+    bool copy_file(const fslib::PathView &source,
+                   const fslib::PathView &destination,
+                   const fslib::CopyOptions &options = {},
+                   fslib::CopyStats *statsOut        = nullptr);
+
+    /**
+     * @brief Copies the directory at source to destination along with everything in it.
+     *
+     * @param source Path of the directory to copy.
+     * @param destination Path to copy the directory to. This and every directory under it is created if needed.
+     * @param options Optional. Threads, buffers and file size limits to use.
+     * @param statsOut Optional. Pointer to write the numbers from the copy to.
+     * @return True on success. False if anything failed to copy.
+     * @note The directory tree is created first. Files are then spread across a pool of worker threads. Small files are
+     * batched together and large files are split so every worker stays busy.
+     */
+    bool copy_directory_recursively(const fslib::PathView &source,
+                                    const fslib::PathView &destination,
+                                    const fslib::CopyOptions &options = {},
+                                    fslib::CopyStats *statsOut        = nullptr);
+} // namespace fslib
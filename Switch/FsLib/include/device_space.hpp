@@ -1,5 +1,5 @@
 #pragma once
-#include "Path.hpp"
+#include "PathView.hpp"
 
 namespace fslib
 {
@@ -11,7 +11,7 @@ namespace fslib
      * @return Size on success. -1 on failure.
      * @note This function requires a path to work. DeviceRoot should be `sdmc:/` instead of `sdmc`, for example.
      */
-    int64_t get_device_free_space(const fslib::Path &deviceRoot);
+    int64_t get_device_free_space(const fslib::PathView &deviceRoot);
 
     /**
      * @brief Attempts to get the total space of Device passed.
@@ -21,5 +21,5 @@ namespace fslib
      * @return Size on success. -1 on failure.
      * @note This function requires a path to work. DeviceRoot should be `sdmc:/` instead of `sdmc`, for example.
      */
-    int64_t get_device_total_space(const fslib::Path &deviceRoot);
+    int64_t get_device_total_space(const fslib::PathView &deviceRoot);
 }
\ No newline at end of file
@@ -1,47 +1,82 @@
 #pragma once
-#include "Path.hpp"
+#include "PathView.hpp"
 
 namespace fslib
 {
+    /// @brief Options for get_directory_size.
+    struct DirectorySizeOptions
+    {
+            /// @brief Number of threads used to read directories.
+            int threadCount = 4;
+
+            /// @brief Whether or not the result is cached and a cached result can be returned. Cached sizes are dropped when
+            /// fslib changes anything under the directory, but not when something outside of fslib does.
+            bool useCache = false;
+    };
+
+    /// @brief Options for delete_directory_recursively.
+    struct DeleteOptions
+    {
+            /// @brief Number of threads used when the file system can't delete the directory on its own.
+            int threadCount = 4;
+
+            /// @brief Whether or not the directory itself is kept and only its contents are deleted. The root of a device is
+            /// always kept.
+            bool keepRoot = false;
+    };
+
     /// @brief Attempts to create directory with directoryPath.
     /// @param directoryPath Path to new directory.
     /// @return True on success. False on failure.
-    bool create_directory(const fslib::Path &directoryPath);
+    bool create_directory(const fslib::PathView &directoryPath);
 
     /**
      * @brief Attempts to create all directories in path if possible. Path does not need a trailing slash.
      *
      * @param directoryPath Path of directories.
      * @return True on success. False on failure.
-     * @note This can be kind of slow. At the moment, I'm not sure if there's a bug or Switch has some kind of limit on folder
-     * depth, but after a certain point this will fail. Use only where <b>absolutely needed</b>.
+     * @note This works backwards from the end of the path and only creates what's missing. On devices with the metadata
+     * cache on, directories fslib already knows exist aren't checked again, so creating a lot of directories under the same
+     * parent only costs what's new.
      */
-    bool create_directories_recursively(const fslib::Path &directoryPath);
+    bool create_directories_recursively(const fslib::PathView &directoryPath);
 
     /// @brief Attempts to delete the directory passed.
     /// @param directoryPath Path to the target directory.
     /// @return True on success. False on failure.
-    bool delete_directory(const fslib::Path &directoryPath);
+    bool delete_directory(const fslib::PathView &directoryPath);
 
     /// @brief Attempts to delete directory path recursively.
     /// @param directoryPath Path to target directory.
+    /// @param options Optional. Threads to use and whether or not to keep the directory itself.
     /// @return True on success. False on failure.
-    bool delete_directory_recursively(const fslib::Path &directoryPath);
+    /// @note The file system is asked to do this on its own first. Everything is only deleted one at a time if it can't.
+    bool delete_directory_recursively(const fslib::PathView &directoryPath, const fslib::DeleteOptions &options = {});
 
     /// @brief Attempts to open directory for reading to see if it exists. Can also be used to test if something is a directory.
     /// @param directoryPath Path to the target directory.
     /// @return True on success. False on failure.
-    bool directory_exists(const fslib::Path &directoryPath);
+    bool directory_exists(const fslib::PathView &directoryPath);
 
     /// @brief Attempts to rename OldPath to NewPath.
     /// @param oldPath Original path to target directory.
     /// @param newPath New path to target directory.
     /// @return True on success. False on failure.
-    bool rename_directory(const fslib::Path &oldPath, const fslib::Path &newPath);
+    bool rename_directory(const fslib::PathView &oldPath, const fslib::PathView &newPath);
 
     /// @brief Attempts to get a count for the number of entries in a directory.
     /// @param directoryPath Path of the directory to get the entry count for.
     /// @param countOut Int64_t to write the count to.
     /// @return True on success. False on failure.
-    bool get_directory_entry_count(const fslib::Path &directoryPath, int64_t &countOut);
+    bool get_directory_entry_count(const fslib::PathView &directoryPath, int64_t &countOut);
+
+    /// @brief Gets the total size of every file under the directory passed.
+    /// @param directoryPath Path of the directory.
+    /// @param options Optional. Threads and caching to use.
+    /// @return Total size on success. -1 on failure, including when any directory under it couldn't be read all the way
+    /// through. Nothing is cached then.
+    int64_t get_directory_size(const fslib::PathView &directoryPath, const fslib::DirectorySizeOptions &options = {});
+
+    /// @brief Drops every directory size cached by get_directory_size.
+    void clear_directory_size_cache();
 } // namespace fslib
@@ -22,10 +22,16 @@ namespace fslib
             static constexpr uint32_t UNABLE_TO_RESIZE     = 8;
         } // namespace codes
 
-        /// @brief Returns the internal error string.
+        /// @brief Returns the error string for the last error recorded by the calling thread.
+        /// @note The string is built the first time this is called after an error. It belongs to the calling thread and is
+        /// overwritten the next time that thread records an error.
         const char *get_string();
 
-        /// @brief Creates an error string.
+        /// @brief Returns the code of the last error recorded by the calling thread. 0 if there hasn't been one.
+        Result get_code();
+
+        /// @brief Records the code and where it happened for the calling thread if the code is a failure.
+        /// @return True if the code is a failure. False if it isn't.
         bool occurred(Result code, const std::source_location &location = std::source_location::current());
     } // namespace error
 } // namespace fslib
@@ -1,11 +1,16 @@
 #pragma once
 #include "Directory.hpp"
+#include "DirectoryReader.hpp"
+#include "DirectoryView.hpp"
 #include "File.hpp"
 #include "Path.hpp"
+#include "PathView.hpp"
 #include "SaveInfoReader.hpp"
+#include "SequentialReader.hpp"
 #include "Storage.hpp"
 #include "bis_file_system.hpp"
 #include "commit.hpp"
+#include "copy_functions.hpp"
 #include "dev.hpp"
 #include "device.hpp"
 #include "device_space.hpp"
@@ -13,6 +18,9 @@
 #include "error.hpp"
 #include "file_functions.hpp"
 #include "save_file_system.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "walk.hpp"
 
 #include <string_view>
 #include <switch.h>
@@ -43,8 +51,30 @@ namespace fslib
     /// ctrulib.
     bool get_file_system_by_device_name(std::string_view deviceName, FsFileSystem **filesystem);
 
+    /// @brief Gets the file system for the device of the path passed.
+    /// @param path Path to get the file system for.
+    /// @param filesystemOut Set to pointer to FileSystem handle mapped to the path's device.
+    /// @return True if the device is found, false if it isn't.
+    /// @note Paths remember the device they were resolved to, so this only searches the map if the device was closed or
+    /// remapped since then, or was never found to begin with.
+    bool get_file_system(const fslib::PathView &path, FsFileSystem **filesystemOut);
+
     /// @brief Closes filesystem mapped to DeviceName
     /// @param deviceName Name of device to close.
     /// @return True on success. False on Failure or device not found.
     bool close_file_system(std::string_view deviceName);
+
+    /**
+     * @brief Turns the metadata cache on or off for DeviceName.
+     *
+     * @param deviceName Name of the device.
+     * @param enable Whether to enable or disable the cache.
+     * @param ignoreCase Optional. Whether or not the device ignores case in names like the SD card's FAT32 and exFAT do.
+     * Pass false for file systems that don't, or names that only differ in case are treated as the same path.
+     * @note With the cache on, file_exists, directory_exists and get_file_size answer from memory when they can. The cache is
+     * filled by those calls and by Directory listings, and kept up to date by fslib's own create, delete, rename and write
+     * calls. create_directories_recursively also skips checking directories it already knows exist. Changes made to the
+     * device outside of fslib aren't seen, so only enable this for devices fslib has to itself.
+     */
+    void enable_metadata_cache(std::string_view deviceName, bool enable = true, bool ignoreCase = true);
 } // namespace fslib
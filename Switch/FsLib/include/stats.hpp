@@ -0,0 +1,86 @@
+#pragma once
+#include "PathView.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief I/O statistics. These are only collected if fslib is built with FSLIB_ENABLE_STATS defined. Ex: make FSLIB_STATS=1
+
+namespace fslib
+{
+    namespace stats
+    {
+        /// @brief Operations latency is recorded for.
+        enum class Operation : uint8_t
+        {
+            OPEN,
+            READ,
+            WRITE,
+            SET_SIZE,
+            DIR_READ,
+            COMMIT
+        };
+
+        /// @brief Number of operations above.
+        static constexpr size_t OPERATION_COUNT = 6;
+
+        /// @brief Number of buckets in each histogram. Bucket 0 is under 1 microsecond. Bucket N is under 2^N microseconds.
+        /// The last bucket holds everything longer than that.
+        static constexpr size_t HISTOGRAM_BUCKETS = 24;
+
+        /// @brief What was recorded for a single operation.
+        struct OperationStats
+        {
+                /// @brief Number of times the operation was performed.
+                uint64_t calls{};
+
+                /// @brief Time spent in the operation in nanoseconds.
+                uint64_t totalNanoseconds{};
+
+                /// @brief Latency histogram.
+                std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{};
+        };
+
+        /// @brief What was recorded for a device.
+        struct DeviceStats
+        {
+                /// @brief Name of the device.
+                std::string deviceName{};
+
+                /// @brief Number of timed service calls made to the device.
+                uint64_t serviceCalls{};
+
+                /// @brief Bytes read from the device.
+                uint64_t bytesRead{};
+
+                /// @brief Bytes written to the device.
+                uint64_t bytesWritten{};
+
+                /// @brief Stats for each operation. Index with Operation.
+                std::array<OperationStats, OPERATION_COUNT> operations{};
+        };
+
+        /// @brief Opaque per-device counters used internally.
+        struct Counters;
+
+        /// @brief Returns whether or not fslib was built with stats.
+        bool is_enabled() noexcept;
+
+        /// @brief Returns the name of the operation passed. Ex: "set_size"
+        const char *get_operation_name(fslib::stats::Operation operation) noexcept;
+
+        /// @brief Returns a copy of everything recorded so far. One entry per device, sorted by name.
+        /// @note This is empty if fslib was built without stats.
+        std::vector<fslib::stats::DeviceStats> get_snapshot();
+
+        /// @brief Zeroes everything recorded so far.
+        void reset();
+
+        /// @brief Writes a readable report of the current snapshot to the path passed.
+        /// @param filePath Path of the file to write to. This is overwritten if it exists.
+        /// @return True on success. False on failure or if fslib was built without stats.
+        bool dump_to_file(const fslib::PathView &filePath);
+    } // namespace stats
+} // namespace fslib
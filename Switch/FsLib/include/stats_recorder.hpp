@@ -0,0 +1,112 @@
+#pragma once
+#include "stats.hpp"
+
+#include <string_view>
+#include <switch.h>
+
+/// @brief Timed versions of the service calls fslib records stats for. Not needed outside of fslib. Without FSLIB_ENABLE_STATS
+/// these just forward to libnx and compile away.
+
+namespace fslib
+{
+    namespace stats
+    {
+#ifdef FSLIB_ENABLE_STATS
+        /// @brief Returns the counters for the device passed. These live as long as fslib does.
+        fslib::stats::Counters *get_counters(std::string_view deviceName);
+
+        /// @brief Records a call that started at startTick.
+        void record(fslib::stats::Counters *counters,
+                    fslib::stats::Operation operation,
+                    uint64_t startTick,
+                    uint64_t bytesRead,
+                    uint64_t bytesWritten) noexcept;
+
+        /// @brief Returns the tick to pass to record.
+        inline uint64_t start() noexcept { return armGetSystemTick(); }
+#else
+        inline fslib::stats::Counters *get_counters(std::string_view) { return nullptr; }
+
+        inline void record(fslib::stats::Counters *, fslib::stats::Operation, uint64_t, uint64_t, uint64_t) noexcept {}
+
+        inline uint64_t start() noexcept { return 0; }
+#endif
+
+        inline Result open_file(fslib::stats::Counters *counters,
+                                FsFileSystem *filesystem,
+                                const char *path,
+                                uint32_t openFlags,
+                                FsFile *fileOut)
+        {
+            const uint64_t startTick = stats::start();
+            const Result openResult  = fsFsOpenFile(filesystem, path, openFlags, fileOut);
+            stats::record(counters, Operation::OPEN, startTick, 0, 0);
+            return openResult;
+        }
+
+        inline Result open_directory(fslib::stats::Counters *counters,
+                                     FsFileSystem *filesystem,
+                                     const char *path,
+                                     uint32_t openFlags,
+                                     FsDir *directoryOut)
+        {
+            const uint64_t startTick = stats::start();
+            const Result openResult  = fsFsOpenDirectory(filesystem, path, openFlags, directoryOut);
+            stats::record(counters, Operation::OPEN, startTick, 0, 0);
+            return openResult;
+        }
+
+        inline Result file_read(fslib::stats::Counters *counters,
+                                FsFile *file,
+                                int64_t offset,
+                                void *buffer,
+                                uint64_t readSize,
+                                uint64_t *bytesRead)
+        {
+            const uint64_t startTick = stats::start();
+            const Result readResult  = fsFileRead(file, offset, buffer, readSize, 0, bytesRead);
+            stats::record(counters, Operation::READ, startTick, R_SUCCEEDED(readResult) ? *bytesRead : 0, 0);
+            return readResult;
+        }
+
+        inline Result file_write(fslib::stats::Counters *counters,
+                                 FsFile *file,
+                                 int64_t offset,
+                                 const void *buffer,
+                                 uint64_t writeSize)
+        {
+            const uint64_t startTick = stats::start();
+            const Result writeResult = fsFileWrite(file, offset, buffer, writeSize, 0);
+            stats::record(counters, Operation::WRITE, startTick, 0, R_SUCCEEDED(writeResult) ? writeSize : 0);
+            return writeResult;
+        }
+
+        inline Result file_set_size(fslib::stats::Counters *counters, FsFile *file, int64_t size)
+        {
+            const uint64_t startTick = stats::start();
+            const Result sizeResult  = fsFileSetSize(file, size);
+            stats::record(counters, Operation::SET_SIZE, startTick, 0, 0);
+            return sizeResult;
+        }
+
+        inline Result directory_read(fslib::stats::Counters *counters,
+                                     FsDir *directory,
+                                     int64_t *entriesRead,
+                                     size_t entryCount,
+                                     FsDirectoryEntry *entriesOut)
+        {
+            const uint64_t startTick = stats::start();
+            const Result readResult  = fsDirRead(directory, entriesRead, entryCount, entriesOut);
+            stats::record(counters, Operation::DIR_READ, startTick, 0, 0);
+            return readResult;
+        }
+
+        inline Result commit(fslib::stats::Counters *counters, FsFileSystem *filesystem)
+        {
+            const uint64_t startTick  = stats::start();
+            const Result commitResult = fsFsCommit(filesystem);
+            stats::record(counters, Operation::COMMIT, startTick, 0, 0);
+            return commitResult;
+        }
+    } // namespace stats
+} // namespace fslib
@@ -0,0 +1,112 @@
+#pragma once
+#include "PathView.hpp"
+
+#include <cstdint>
+
+/// @brief I/O trace recording. Traces are only recorded if fslib is built with FSLIB_ENABLE_TRACE defined. Ex: make
+/// FSLIB_TRACE=1. tools/replay can run a trace again on a PC.
+
+namespace fslib
+{
+    namespace trace
+    {
+        /// @brief First four bytes of every trace. "FSLT"
+        static constexpr uint32_t MAGIC = 0x544C5346;
+
+        /// @brief Version of the format below.
+        static constexpr uint32_t VERSION = 1;
+
+        /// @brief Separates the old and new paths of a rename.
+        static constexpr char PATH_SEPARATOR = '|';
+
+        /// @brief Operations recorded. What each record field holds for each is listed below. Fields not listed are 0.
+        /**
+         * @note
+         *  OPEN_FILE: handle, offset = file size, size = buffer size, flags = open flags, option = growth policy, path.
+         *  CLOSE_FILE, FLUSH, READ_DIRECTORY, CLOSE_DIRECTORY: handle.
+         *  READ, WRITE, READ_AT, WRITE_AT: handle, offset, size requested. For READ and WRITE offset is the file's offset.
+         *  GET_BYTE, PUT_BYTE: handle, offset = the file's offset.
+         *  SEEK: handle, offset passed, option = origin.
+         *  OPEN_DIRECTORY: handle, size = buffer count, flags = 1 for directories | 2 for files, path. Patterns are
+         *      matched by fslib after reading, so they aren't recorded.
+         *  CREATE_FILE: size = file size, path.
+         *  DELETE_FILE, CREATE_DIRECTORY, DELETE_DIRECTORY: path.
+         *  DELETE_DIRECTORY_RECURSIVELY: size = thread count, option = keep root, path.
+         *  RENAME_FILE, RENAME_DIRECTORY: old path and new path.
+         *  COMMIT: path = device name.
+         */
+        enum class Operation : uint8_t
+        {
+            OPEN_FILE,
+            CLOSE_FILE,
+            READ,
+            GET_BYTE,
+            WRITE,
+            PUT_BYTE,
+            READ_AT,
+            WRITE_AT,
+            SEEK,
+            FLUSH,
+            OPEN_DIRECTORY,
+            READ_DIRECTORY,
+            CLOSE_DIRECTORY,
+            CREATE_FILE,
+            DELETE_FILE,
+            RENAME_FILE,
+            CREATE_DIRECTORY,
+            DELETE_DIRECTORY,
+            DELETE_DIRECTORY_RECURSIVELY,
+            RENAME_DIRECTORY,
+            COMMIT
+        };
+
+        /// @brief Number of operations above.
+        static constexpr size_t OPERATION_COUNT = 21;
+
+        /// @brief Written once at the beginning of a trace.
+        struct Header
+        {
+                uint32_t magic;
+                uint32_t version;
+        };
+
+        /// @brief Written for every operation. This is followed by pathLength bytes of path with no NULL terminator.
+        struct Record
+        {
+                /// @brief Nanoseconds from when tracing began to when the operation started.
+                uint64_t timestamp;
+
+                /// @brief Nanoseconds the operation took.
+                uint64_t duration;
+
+                int64_t offset;
+                int64_t size;
+
+                /// @brief Number given to the File or DirectoryReader when it was opened. 0 if it was opened before tracing.
+                uint32_t handle;
+
+                uint32_t flags;
+                uint16_t pathLength;
+                Operation operation;
+                uint8_t option;
+                uint8_t reserved[4];
+        };
+        static_assert(sizeof(Record) == 48);
+
+        /// @brief Returns the name of the operation passed. Ex: "read_at"
+        const char *get_operation_name(fslib::trace::Operation operation) noexcept;
+
+        /// @brief Begins recording to the file passed.
+        /// @param tracePath Path of the file to write the trace to. This is overwritten if it exists.
+        /// @return True on success. False on failure, if a trace is already being recorded or if fslib was built without
+        /// tracing.
+        /// @note The trace is written directly to the file system, so writing it doesn't show up in the trace or stats.
+        bool begin(const fslib::PathView &tracePath);
+
+        /// @brief Stops recording and writes out whatever is still buffered.
+        void end();
+
+        /// @brief Returns whether or not a trace is being recorded.
+        bool is_active() noexcept;
+    } // namespace trace
+} // namespace fslib
@@ -0,0 +1,67 @@
+#pragma once
+#include "trace.hpp"
+
+#include <string_view>
+
+/// @brief Records the public call it's created in when it goes out of scope. Not needed outside of fslib. Without
+/// FSLIB_ENABLE_TRACE this is empty and compiles away.
+
+namespace fslib
+{
+    namespace trace
+    {
+        /// @brief What's recorded for a call. See trace.hpp for what each field holds for each operation.
+        struct Event
+        {
+                fslib::trace::Operation operation{};
+                const void *handle = nullptr;
+                int64_t offset     = 0;
+                int64_t size       = 0;
+                uint32_t flags     = 0;
+                uint8_t option     = 0;
+        };
+
+#ifdef FSLIB_ENABLE_TRACE
+        class Scope final
+        {
+            public:
+                /// @brief Starts timing the call.
+                Scope(const fslib::trace::Event &event) noexcept;
+
+                /// @brief Starts timing a call on a path. The path must outlive the scope.
+                Scope(const fslib::trace::Event &event, const fslib::PathView &path) noexcept;
+
+                /// @brief Starts timing a rename. The paths must outlive the scope.
+                Scope(const fslib::trace::Event &event, const fslib::PathView &path, const fslib::PathView &newPath) noexcept;
+
+                /// @brief Starts timing a call on a device. The name must outlive the scope.
+                Scope(const fslib::trace::Event &event, std::string_view deviceName) noexcept;
+
+                /// @brief Records the call if it's the outermost one on the thread. Calls fslib makes on its own aren't.
+                ~Scope() noexcept;
+
+                Scope(const Scope &)            = delete;
+                Scope &operator=(const Scope &) = delete;
+
+            private:
+                fslib::trace::Event m_event{};
+                const fslib::PathView *m_path{};
+                const fslib::PathView *m_newPath{};
+                std::string_view m_deviceName{};
+                uint64_t m_startTick{};
+        };
+#else
+        class Scope final
+        {
+            public:
+                Scope(const fslib::trace::Event &) noexcept {}
+
+                Scope(const fslib::trace::Event &, const fslib::PathView &) noexcept {}
+
+                Scope(const fslib::trace::Event &, const fslib::PathView &, const fslib::PathView &) noexcept {}
+
+                Scope(const fslib::trace::Event &, std::string_view) noexcept {}
+        };
+#endif
+    } // namespace trace
+} // namespace fslib
@@ -0,0 +1,53 @@
+#pragma once
+#include "Path.hpp"
+#include "PathView.hpp"
+
+#include <functional>
+#include <switch.h>
+
+namespace fslib
+{
+    /// @brief What the walk should do after an entry is visited.
+    enum class WalkAction
+    {
+        /// @brief Keep going. Directories are descended into.
+        CONTINUE,
+
+        /// @brief Don't descend into this directory. This only has an effect in pre-order walks.
+        SKIP,
+
+        /// @brief End the walk as soon as possible.
+        STOP
+    };
+
+    /// @brief Options for walk.
+    struct WalkOptions
+    {
+            /// @brief Number of threads to read directories with. At one or less, everything is done on the calling thread.
+            int threadCount = 1;
+
+            /// @brief Whether or not directories are visited after everything inside of them instead of before.
+            bool postOrder = false;
+    };
+
+    /// @brief Function called for every entry found.
+    /// @param entryPath Full path of the entry.
+    /// @param entry The entry as read from the file system.
+    /// @param depth How many directories deep the entry is. Entries directly under the root are zero.
+    using WalkVisitor =
+        std::function<fslib::WalkAction(const fslib::Path &entryPath, const FsDirectoryEntry &entry, int depth)>;
+
+    /**
+     * @brief Walks everything under root breadth first and calls visitor for every entry. The root itself isn't visited.
+     *
+     * @param root Directory to start at.
+     * @param visitor Function called for each entry.
+     * @param options Optional. Threads and visiting order.
+     * @return True if every directory was read. False if any couldn't be opened or read all the way through. In post-order
+     * walks, those directories aren't visited.
+     * @note Directories are read in batches, so memory use depends on how many directories are waiting to be read, not how
+     * many entries they hold. With more than one thread, visitor is called from the worker threads and can be running on
+     * more than one of them at once.
+     */
+    bool walk(const fslib::PathView &root, const fslib::WalkVisitor &visitor, const fslib::WalkOptions &options = {});
+} // namespace fslib
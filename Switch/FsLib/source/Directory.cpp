@@ -1,27 +1,45 @@
 #include "Directory.hpp"
 
-#include "error.hpp"
-#include "fslib.hpp"
+#include "DirectoryReader.hpp"
+#include "cache.hpp"
 
 #include <algorithm>
 #include <cstring>
 #include <string>
 
-/// @brief Function used to sort by directories->alphabetically.
-static bool compare_entries(const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB);
+namespace
+{
+    /// @brief Average name length guessed when reserving the name arena.
+    constexpr size_t NAME_ARENA_GUESS = 0x20;
+} // namespace
+
+/// @brief Compares two folded keys byte by byte.
+static int compare_keys(const char *keyA, size_t lengthA, const char *keyB, size_t lengthB);
+
+/// @brief Compares two folded keys with runs of digits compared by value so file2 comes before file10.
+static int compare_keys_natural(const char *keyA, size_t lengthA, const char *keyB, size_t lengthB);
 
-fslib::Directory::Directory(const fslib::Path &directoryPath, bool sortedListing)
+fslib::Directory::Directory(const fslib::PathView &directoryPath, bool sortedListing, bool naturalSort)
 {
-    Directory::open(directoryPath, sortedListing);
+    Directory::open(directoryPath, sortedListing, naturalSort);
+}
+
+fslib::Directory::Directory(const fslib::PathView &directoryPath,
+                            const fslib::DirectoryFilter &filter,
+                            bool sortedListing,
+                            bool naturalSort)
+{
+    Directory::open(directoryPath, filter, sortedListing, naturalSort);
 }
 
 fslib::Directory::Directory(Directory &&directory) noexcept
     : m_wasRead(directory.m_wasRead)
-    , m_handle(directory.m_handle)
     , m_entryCount(directory.m_entryCount)
     , m_directoryList(std::move(directory.m_directoryList))
+    , m_nameArena(std::move(directory.m_nameArena))
+    , m_keyArena(std::move(directory.m_keyArena))
+    , m_naturalSort(directory.m_naturalSort)
 {
-    directory.m_handle     = {0};
     directory.m_entryCount = 0;
     directory.m_wasRead    = 0;
 }
@@ -29,53 +47,98 @@ fslib::Directory::Directory(Directory &&directory) noexcept
 fslib::Directory &fslib::Directory::operator=(Directory &&directory) noexcept
 {
     // Start by copying this to make sure we have EVERYTHING~
-    m_handle        = directory.m_handle;
     m_directoryList = std::move(directory.m_directoryList);
+    m_nameArena     = std::move(directory.m_nameArena);
+    m_keyArena      = std::move(directory.m_keyArena);
+    m_naturalSort   = directory.m_naturalSort;
     m_entryCount    = directory.m_entryCount;
     m_wasRead       = directory.m_wasRead;
 
-    directory.m_handle = {0};
-    m_directoryList.clear(); // Not really sure if this is needed after std::move, but jic.
-    m_entryCount = 0;
-    m_wasRead    = 0;
+    directory.m_directoryList.clear(); // Not really sure if this is needed after std::move, but jic.
+    directory.m_nameArena.clear();
+    directory.m_keyArena.clear();
+    directory.m_entryCount = 0;
+    directory.m_wasRead    = 0;
 
     return *this;
 }
 
-void fslib::Directory::open(const fslib::Path &directoryPath, bool sortedListing)
+void fslib::Directory::open(const fslib::PathView &directoryPath, bool sortedListing, bool naturalSort)
 {
-    static constexpr uint32_t FLAGS_DIR_OPEN = FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles;
+    Directory::open(directoryPath, fslib::DirectoryFilter{}, sortedListing, naturalSort);
+}
 
+void fslib::Directory::open(const fslib::PathView &directoryPath,
+                            const fslib::DirectoryFilter &filter,
+                            bool sortedListing,
+                            bool naturalSort)
+{
     // Oops. Need this too!
     m_directoryList.clear();
+    m_nameArena.clear();
+    m_keyArena.clear();
+    m_entryCount = 0;
 
     // This so directories can be reused.
     m_wasRead = false;
-    if (!directoryPath.is_valid()) { return; }
 
-    FsFileSystem *filesystem{};
-    const std::string_view device = directoryPath.get_device_name();
-    const char *path              = directoryPath.get_path();
-    const bool deviceFound        = fslib::get_file_system_by_device_name(device, &filesystem);
-    if (!deviceFound) { return; }
+    // Entries are read in batches so the only thing that grows with the directory is the list itself.
+    DirectoryReader reader{directoryPath, DirectoryReader::DEFAULT_BUFFER_COUNT, filter};
+    if (!reader.is_open()) { return; }
 
-    const bool dirError   = error::occurred(fsFsOpenDirectory(filesystem, path, FLAGS_DIR_OPEN, &m_handle));
-    const bool countError = !dirError && error::occurred(fsDirGetEntryCount(&m_handle, &m_entryCount));
-    if (dirError || countError) { return; }
+    int64_t entryCount{};
+    const bool countError = !reader.get_entry_count(entryCount);
+    if (countError) { return; }
 
-    m_directoryList.reserve(m_entryCount);
-    auto entryBuffer = std::make_unique<FsDirectoryEntry[]>(m_entryCount);
+    // The count doesn't know about the pattern. Reserving it for a pattern would defeat the point of filtering.
+    if (filter.pattern.empty())
+    {
+        m_directoryList.reserve(entryCount);
+        m_nameArena.reserve(entryCount * NAME_ARENA_GUESS);
+    }
+    while (reader.read())
+    {
+        for (const FsDirectoryEntry &entry : reader)
+        {
+            const size_t nameLength = strnlen(entry.name, sizeof(entry.name) - 1);
+            const size_t nameOffset = m_nameArena.size();
+            m_nameArena.insert(m_nameArena.end(), entry.name, entry.name + nameLength);
+            m_nameArena.push_back('\0');
+            m_directoryList.push_back(
+                DirectoryEntry{entry, static_cast<uint32_t>(nameOffset), static_cast<uint32_t>(nameLength)});
+        }
+    }
 
-    // This is how many entries the function says are read.
-    int64_t totalEntries{};
-    const bool readError    = error::occurred(fsDirRead(&m_handle, &totalEntries, m_entryCount, entryBuffer.get()));
-    const bool entriesMatch = totalEntries == m_entryCount;
-    if (readError || !entriesMatch) { return; }
+    // Half a listing isn't a listing.
+    if (reader.read_failed())
+    {
+        m_directoryList.clear();
+        m_nameArena.clear();
+        return;
+    }
+    m_entryCount = m_directoryList.size();
+
+    // The arena can't move anymore, so this is safe now.
+    const char *nameArena = m_nameArena.data();
+    for (DirectoryEntry &entry : m_directoryList) { entry.m_nameArena = nameArena; }
 
-    for (int64_t i = 0; i < m_entryCount; i++) { m_directoryList.emplace_back(entryBuffer[i]); }
+    // Only a complete listing can be used to say what doesn't exist.
+    const bool completeListing = filter.directories && filter.files && filter.pattern.empty();
+    if (completeListing && cache::metadata_enabled(directoryPath.get_device_name())) { cache::add_listing(directoryPath, *this); }
 
-    if (sortedListing) { std::sort(m_directoryList.begin(), m_directoryList.end(), compare_entries); }
-    Directory::close();
+    if (sortedListing)
+    {
+        m_naturalSort = naturalSort;
+        Directory::build_sort_keys();
+        std::sort(m_directoryList.begin(),
+                  m_directoryList.end(),
+                  [this](const DirectoryEntry &entryA, const DirectoryEntry &entryB) {
+                      return Directory::compare_entries(entryA, entryB);
+                  });
+
+        // The keys aren't needed once everything is in order.
+        m_keyArena = std::vector<char>{};
+    }
     m_wasRead = true;
 }
 
@@ -91,24 +154,75 @@ fslib::Directory::iterator fslib::Directory::begin() const noexcept { return m_d
 
 fslib::Directory::iterator fslib::Directory::end() const noexcept { return m_directoryList.end(); }
 
-void fslib::Directory::close() { fsDirClose(&m_handle); }
+void fslib::Directory::build_sort_keys()
+{
+    // The keys share offsets with the names, so an entry's key is found the same way its name is.
+    m_keyArena.resize(m_nameArena.size());
+    std::transform(m_nameArena.begin(), m_nameArena.end(), m_keyArena.begin(), [](char character) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+    });
+}
 
-static bool compare_entries(const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB)
+bool fslib::Directory::compare_entries(const fslib::DirectoryEntry &entryA,
+                                       const fslib::DirectoryEntry &entryB) const noexcept
 {
     const bool isDirA = entryA.is_directory();
     const bool isDirB = entryB.is_directory();
     if (isDirA != isDirB) { return isDirA; }
 
-    const char *nameA          = entryA.get_filename();
-    const char *nameB          = entryB.get_filename();
-    const size_t entryALength  = std::char_traits<char>::length(nameA);
-    const size_t entryBLength  = std::char_traits<char>::length(nameB);
-    const size_t shortestEntry = entryALength < entryBLength ? entryALength : entryBLength;
-    for (size_t i = 0; i < shortestEntry; i++)
+    const char *keyA     = &m_keyArena[entryA.m_nameOffset];
+    const char *keyB     = &m_keyArena[entryB.m_nameOffset];
+    const size_t lengthA = entryA.m_nameLength;
+    const size_t lengthB = entryB.m_nameLength;
+    if (m_naturalSort) { return compare_keys_natural(keyA, lengthA, keyB, lengthB) < 0; }
+
+    return compare_keys(keyA, lengthA, keyB, lengthB) < 0;
+}
+
+static int compare_keys(const char *keyA, size_t lengthA, const char *keyB, size_t lengthB)
+{
+    const size_t shortest = lengthA < lengthB ? lengthA : lengthB;
+    const int result      = std::memcmp(keyA, keyB, shortest);
+    if (result != 0) { return result; }
+
+    return lengthA < lengthB ? -1 : lengthA > lengthB ? 1 : 0;
+}
+
+static int compare_keys_natural(const char *keyA, size_t lengthA, const char *keyB, size_t lengthB)
+{
+    auto isDigit = [](char character) { return character >= '0' && character <= '9'; };
+
+    size_t a{}, b{};
+    while (a < lengthA && b < lengthB)
     {
-        const int charA = std::tolower(nameA[i]);
-        const int charB = std::tolower(nameB[i]);
-        if (charA != charB) { return charA < charB; }
+        if (!isDigit(keyA[a]) || !isDigit(keyB[b]))
+        {
+            const unsigned char charA = keyA[a++];
+            const unsigned char charB = keyB[b++];
+            if (charA != charB) { return charA < charB ? -1 : 1; }
+            continue;
+        }
+
+        // Leading zeroes don't change the value. After that, the longer run is the bigger number.
+        while (a < lengthA && keyA[a] == '0') { ++a; }
+        while (b < lengthB && keyB[b] == '0') { ++b; }
+
+        size_t runEndA = a, runEndB = b;
+        while (runEndA < lengthA && isDigit(keyA[runEndA])) { ++runEndA; }
+        while (runEndB < lengthB && isDigit(keyB[runEndB])) { ++runEndB; }
+
+        const size_t digitsA = runEndA - a;
+        const size_t digitsB = runEndB - b;
+        if (digitsA != digitsB) { return digitsA < digitsB ? -1 : 1; }
+
+        const int result = std::memcmp(&keyA[a], &keyB[b], digitsA);
+        if (result != 0) { return result; }
+
+        a = runEndA;
+        b = runEndB;
     }
-    return true;
+
+    const size_t leftA = lengthA - a;
+    const size_t leftB = lengthB - b;
+    return leftA < leftB ? -1 : leftA > leftB ? 1 : 0;
 }
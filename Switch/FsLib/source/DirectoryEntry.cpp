@@ -1,45 +1,26 @@
 #include "DirectoryEntry.hpp"
 
-#include <cstring>
-#include <string>
+#include <string_view>
 
-fslib::DirectoryEntry::DirectoryEntry(const FsDirectoryEntry &entry)
-    : m_directory(entry.type == FsDirEntryType_Dir)
-    , m_filename(entry.name)
-    , m_size(entry.file_size) {};
-
-fslib::DirectoryEntry::DirectoryEntry(DirectoryEntry &&entry) noexcept
-    : m_directory(entry.m_directory)
-    , m_filename(std::move(entry.m_filename))
-    , m_size(entry.m_size)
-
-{
-    entry.m_directory = false;
-    entry.m_size      = 0;
-}
-
-fslib::DirectoryEntry &fslib::DirectoryEntry::operator=(DirectoryEntry &&entry) noexcept
-{
-    m_directory = entry.m_directory;
-    m_filename  = std::move(entry.m_filename);
-    m_size      = entry.m_size;
-
-    entry.m_directory = false;
-    entry.m_size      = 0;
-
-    return *this;
-}
+fslib::DirectoryEntry::DirectoryEntry(const FsDirectoryEntry &entry, uint32_t nameOffset, uint32_t nameLength) noexcept
+    : m_size(entry.file_size)
+    , m_nameOffset(nameOffset)
+    , m_nameLength(nameLength)
+    , m_directory(entry.type == FsDirEntryType_Dir) {};
 
 bool fslib::DirectoryEntry::is_directory() const noexcept { return m_directory; }
 
-const char *fslib::DirectoryEntry::get_filename() const noexcept { return m_filename.c_str(); }
+const char *fslib::DirectoryEntry::get_filename() const noexcept { return &m_nameArena[m_nameOffset]; }
+
+size_t fslib::DirectoryEntry::get_filename_length() const noexcept { return m_nameLength; }
 
 const char *fslib::DirectoryEntry::get_extension() const noexcept
 {
-    const size_t lastDot = m_filename.find_last_of('.');
-    if (lastDot == m_filename.npos) { return nullptr; }
+    const std::string_view filename{&m_nameArena[m_nameOffset], m_nameLength};
+    const size_t lastDot = filename.find_last_of('.');
+    if (lastDot == filename.npos) { return nullptr; }
 
-    return &m_filename.data()[lastDot];
+    return &filename.data()[lastDot];
 }
 
 int64_t fslib::DirectoryEntry::get_size() const noexcept { return m_size; }
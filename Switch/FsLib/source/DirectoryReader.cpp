@@ -0,0 +1,197 @@
+#include "DirectoryReader.hpp"
+
+#include "error.hpp"
+#include "fslib.hpp"
+#include "stats_recorder.hpp"
+#include "trace_recorder.hpp"
+
+#include <cctype>
+
+/// @brief Returns whether name matches pattern. * matches any run of characters and ? matches exactly one. Case is ignored.
+static bool matches_pattern(const char *name, std::string_view pattern);
+
+fslib::DirectoryReader::DirectoryReader(const fslib::PathView &directoryPath,
+                                        size_t bufferCount,
+                                        const fslib::DirectoryFilter &filter)
+{
+    DirectoryReader::open(directoryPath, bufferCount, filter);
+}
+
+fslib::DirectoryReader::DirectoryReader(DirectoryReader &&directoryReader) noexcept
+    : m_handle(directoryReader.m_handle)
+    , m_isOpen(directoryReader.m_isOpen)
+    , m_bufferCount(directoryReader.m_bufferCount)
+    , m_readCount(directoryReader.m_readCount)
+    , m_readFailed(directoryReader.m_readFailed)
+    , m_entryBuffer(std::move(directoryReader.m_entryBuffer))
+    , m_pattern(std::move(directoryReader.m_pattern))
+    , m_stats(directoryReader.m_stats)
+{
+    directoryReader.m_handle      = {0};
+    directoryReader.m_isOpen      = false;
+    directoryReader.m_bufferCount = 0;
+    directoryReader.m_readCount   = 0;
+    directoryReader.m_readFailed  = false;
+    directoryReader.m_stats       = nullptr;
+}
+
+fslib::DirectoryReader &fslib::DirectoryReader::operator=(DirectoryReader &&directoryReader) noexcept
+{
+    DirectoryReader::close();
+
+    m_handle      = directoryReader.m_handle;
+    m_isOpen      = directoryReader.m_isOpen;
+    m_bufferCount = directoryReader.m_bufferCount;
+    m_readCount   = directoryReader.m_readCount;
+    m_readFailed  = directoryReader.m_readFailed;
+    m_entryBuffer = std::move(directoryReader.m_entryBuffer);
+    m_pattern     = std::move(directoryReader.m_pattern);
+    m_stats       = directoryReader.m_stats;
+
+    directoryReader.m_handle      = {0};
+    directoryReader.m_isOpen      = false;
+    directoryReader.m_bufferCount = 0;
+    directoryReader.m_readCount   = 0;
+    directoryReader.m_readFailed  = false;
+    directoryReader.m_stats       = nullptr;
+
+    return *this;
+}
+
+fslib::DirectoryReader::~DirectoryReader() { DirectoryReader::close(); }
+
+void fslib::DirectoryReader::open(const fslib::PathView &directoryPath, size_t bufferCount, const fslib::DirectoryFilter &filter)
+{
+    trace::Scope traceScope{{.operation = trace::Operation::OPEN_DIRECTORY,
+                             .handle    = this,
+                             .size      = static_cast<int64_t>(bufferCount),
+                             .flags     = (filter.directories ? 1U : 0U) | (filter.files ? 2U : 0U)},
+                            directoryPath};
+    DirectoryReader::close();
+    m_readFailed = false;
+    if (!directoryPath.is_valid() || bufferCount == 0 || (!filter.directories && !filter.files)) { return; }
+
+    FsFileSystem *filesystem{};
+    const bool found = fslib::get_file_system(directoryPath, &filesystem);
+    if (!found) { return; }
+
+    // Let the file system drop the types we don't want instead of doing it here.
+    uint32_t openFlags{};
+    if (filter.directories) { openFlags |= FsDirOpenMode_ReadDirs; }
+    if (filter.files) { openFlags |= FsDirOpenMode_ReadFiles; }
+
+    fslib::PathView::Buffer pathBuffer;
+    const char *path     = directoryPath.get_path(pathBuffer);
+    m_stats              = stats::get_counters(directoryPath.get_device_name());
+    const bool openError = error::occurred(stats::open_directory(m_stats, filesystem, path, openFlags, &m_handle));
+    if (openError) { return; }
+
+    // The buffer is kept around between opens if the count didn't change.
+    if (!m_entryBuffer || bufferCount != m_bufferCount) { m_entryBuffer = std::make_unique<FsDirectoryEntry[]>(bufferCount); }
+    m_bufferCount = bufferCount;
+    m_pattern     = filter.pattern;
+    m_isOpen      = true;
+}
+
+void fslib::DirectoryReader::close() noexcept
+{
+    m_readCount = 0;
+    if (!m_isOpen) { return; }
+
+    trace::Scope traceScope{{.operation = trace::Operation::CLOSE_DIRECTORY, .handle = this}};
+    fsDirClose(&m_handle);
+    m_isOpen = false;
+}
+
+bool fslib::DirectoryReader::is_open() const noexcept { return m_isOpen; }
+
+bool fslib::DirectoryReader::read() noexcept
+{
+    if (!m_isOpen) { return false; }
+    trace::Scope traceScope{{.operation = trace::Operation::READ_DIRECTORY, .handle = this}};
+
+    // Keep going until something passes the pattern or the directory runs out.
+    do {
+        int64_t entriesRead{};
+        const bool readError = error::occurred(
+            stats::directory_read(m_stats, &m_handle, &entriesRead, m_bufferCount, m_entryBuffer.get()));
+        if (readError || entriesRead <= 0)
+        {
+            m_readCount  = 0;
+            m_readFailed = readError;
+            return false;
+        }
+
+        if (m_pattern.empty())
+        {
+            m_readCount = entriesRead;
+            break;
+        }
+
+        // Matches are packed to the front of the buffer.
+        m_readCount = 0;
+        for (int64_t i = 0; i < entriesRead; i++)
+        {
+            if (!matches_pattern(m_entryBuffer[i].name, m_pattern)) { continue; }
+            if (i != m_readCount) { m_entryBuffer[m_readCount] = m_entryBuffer[i]; }
+            ++m_readCount;
+        }
+    } while (m_readCount == 0);
+
+    return true;
+}
+
+bool fslib::DirectoryReader::read_failed() const noexcept { return m_readFailed; }
+
+int64_t fslib::DirectoryReader::get_read_count() const noexcept { return m_readCount; }
+
+bool fslib::DirectoryReader::get_entry_count(int64_t &countOut) noexcept
+{
+    if (!m_isOpen) { return false; }
+
+    const bool countError = error::occurred(fsDirGetEntryCount(&m_handle, &countOut));
+    if (countError) { return false; }
+
+    return true;
+}
+
+const FsDirectoryEntry &fslib::DirectoryReader::operator[](int index) const noexcept { return m_entryBuffer[index]; }
+
+const FsDirectoryEntry *fslib::DirectoryReader::begin() const noexcept { return &m_entryBuffer[0]; }
+
+const FsDirectoryEntry *fslib::DirectoryReader::end() const noexcept { return &m_entryBuffer[m_readCount]; }
+
+static bool matches_pattern(const char *name, std::string_view pattern)
+{
+    auto charsMatch = [](char nameChar, char patternChar) {
+        return patternChar == '?' || std::tolower(static_cast<unsigned char>(nameChar)) ==
+                                         std::tolower(static_cast<unsigned char>(patternChar));
+    };
+
+    // Greedy matching. On a mismatch, go back to the last * and let it eat one more character.
+    const size_t patternLength = pattern.length();
+    size_t patternIndex{}, starIndex = pattern.npos, starName{};
+    size_t nameIndex{};
+    while (name[nameIndex] != '\0')
+    {
+        if (patternIndex < patternLength && pattern[patternIndex] == '*')
+        {
+            starIndex = patternIndex++;
+            starName  = nameIndex;
+        }
+        else if (patternIndex < patternLength && charsMatch(name[nameIndex], pattern[patternIndex]))
+        {
+            ++patternIndex;
+            ++nameIndex;
+        }
+        else if (starIndex != pattern.npos)
+        {
+            patternIndex = starIndex + 1;
+            nameIndex    = ++starName;
+        }
+        else { return false; }
+    }
+
+    while (patternIndex < patternLength && pattern[patternIndex] == '*') { ++patternIndex; }
+    return patternIndex == patternLength;
+}
@@ -0,0 +1,128 @@
+#include "DirectoryView.hpp"
+
+#include "directory_functions.hpp"
+
+#include <algorithm>
+
+fslib::DirectoryView::DirectoryView(const fslib::PathView &directoryPath, int pageSize, bool naturalSort)
+{
+    DirectoryView::open(directoryPath, pageSize, naturalSort);
+}
+
+void fslib::DirectoryView::open(const fslib::PathView &directoryPath, int pageSize, bool naturalSort)
+{
+    m_isOpen     = false;
+    m_pageSize   = 0;
+    m_entryCount = 0;
+    m_directory  = fslib::Directory{};
+    m_sortedPages.clear();
+    m_boundaries.clear();
+    if (pageSize <= 0) { return; }
+
+    // This only asks the file system for the count. Nothing is read until the first page is needed.
+    const bool countError = !fslib::get_directory_entry_count(directoryPath, m_entryCount);
+    if (countError) { return; }
+
+    m_directoryPath = fslib::Path{directoryPath};
+    m_pageSize      = pageSize;
+    m_naturalSort   = naturalSort;
+    m_isOpen        = true;
+}
+
+bool fslib::DirectoryView::is_open() const noexcept { return m_isOpen; }
+
+int64_t fslib::DirectoryView::get_count() const noexcept { return m_entryCount; }
+
+int fslib::DirectoryView::get_page_size() const noexcept { return m_pageSize; }
+
+int fslib::DirectoryView::get_page_count() const noexcept
+{
+    if (m_pageSize <= 0) { return 0; }
+
+    return (m_entryCount + m_pageSize - 1) / m_pageSize;
+}
+
+bool fslib::DirectoryView::load_page(int page)
+{
+    if (!m_isOpen) { return false; }
+
+    const bool listingRead = m_directory.is_open() || DirectoryView::read_listing();
+    if (!listingRead || page < 0 || page >= DirectoryView::get_page_count()) { return false; }
+    if (m_sortedPages[page]) { return true; }
+
+    // Boundaries are only ever placed between pages, so the nearest ones on either side bound the range that still
+    // holds this page's entries.
+    int lowBoundary = page;
+    while (!m_boundaries[lowBoundary]) { --lowBoundary; }
+
+    int highBoundary = page + 1;
+    while (!m_boundaries[highBoundary]) { ++highBoundary; }
+
+    const int64_t pageBegin  = static_cast<int64_t>(page) * m_pageSize;
+    const int64_t pageEnd    = std::min(pageBegin + m_pageSize, m_entryCount);
+    const int64_t rangeBegin = static_cast<int64_t>(lowBoundary) * m_pageSize;
+    const int64_t rangeEnd   = std::min(static_cast<int64_t>(highBoundary) * m_pageSize, m_entryCount);
+
+    auto listBegin = m_directory.m_directoryList.begin();
+    auto compare   = [this](const fslib::DirectoryEntry &entryA, const fslib::DirectoryEntry &entryB) {
+        return m_directory.compare_entries(entryA, entryB);
+    };
+
+    if (rangeBegin != pageBegin)
+    {
+        std::nth_element(listBegin + rangeBegin, listBegin + pageBegin, listBegin + rangeEnd, compare);
+        m_boundaries[page] = true;
+    }
+
+    if (pageEnd != rangeEnd)
+    {
+        std::partial_sort(listBegin + pageBegin, listBegin + pageEnd, listBegin + rangeEnd, compare);
+        m_boundaries[page + 1] = true;
+    }
+    else { std::sort(listBegin + pageBegin, listBegin + pageEnd, compare); }
+
+    m_sortedPages[page] = true;
+    return true;
+}
+
+const fslib::DirectoryEntry &fslib::DirectoryView::get_entry(int index)
+{
+    const bool inBounds = m_isOpen && m_pageSize > 0 && index >= 0 && index < m_entryCount;
+    if (!inBounds || !DirectoryView::load_page(index / m_pageSize)) { return DirectoryView::get_empty_entry(); }
+
+    // Reading the listing can shrink the count, so this is checked again.
+    if (index >= m_directory.get_count()) { return DirectoryView::get_empty_entry(); }
+
+    return m_directory[index];
+}
+
+const fslib::DirectoryEntry &fslib::DirectoryView::operator[](int index) { return DirectoryView::get_entry(index); }
+
+bool fslib::DirectoryView::read_listing()
+{
+    m_directory.open(m_directoryPath, false);
+    if (!m_directory.is_open()) { return false; }
+
+    m_directory.m_naturalSort = m_naturalSort;
+    m_directory.build_sort_keys();
+
+    // The directory could have changed since the count was taken. What was actually read wins.
+    m_entryCount        = m_directory.get_count();
+    const int pageCount = DirectoryView::get_page_count();
+    m_sortedPages.assign(pageCount, false);
+    m_boundaries.assign(pageCount + 1, false);
+    m_boundaries.front() = true;
+    m_boundaries.back()  = true;
+
+    return true;
+}
+
+const fslib::DirectoryEntry &fslib::DirectoryView::get_empty_entry() noexcept
+{
+    static const fslib::DirectoryEntry emptyEntry = []() {
+        fslib::DirectoryEntry entry{FsDirectoryEntry{}, 0, 0};
+        entry.m_nameArena = "";
+        return entry;
+    }();
+    return emptyEntry;
+}
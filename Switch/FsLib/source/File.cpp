@@ -1,8 +1,10 @@
 #include "File.hpp"
 
+#include "cache.hpp"
 #include "error.hpp"
-#include "file_functions.hpp"
 #include "fslib.hpp"
+#include "stats_recorder.hpp"
+#include "trace_recorder.hpp"
 
 #include <cstdarg>
 #include <cstring>
@@ -12,106 +14,227 @@ namespace
 {
     // Buffer size for writef.
     constexpr size_t VA_BUFFER_SIZE = 0x1000;
+
+    // Smallest allocation GrowthPolicy::GEOMETRIC will make.
+    constexpr int64_t GEOMETRIC_MINIMUM = 0x100000;
+
+    // Largest single step GrowthPolicy::GEOMETRIC will take. Save data doesn't have space to waste.
+    constexpr int64_t GEOMETRIC_MAXIMUM_STEP = 0x4000000;
 } // namespace
 
 extern void print(const char *format, ...);
 
-fslib::File::File(const fslib::Path &filePath, uint32_t openFlags, int64_t fileSize) noexcept
+fslib::File::File(const fslib::PathView &filePath,
+                  uint32_t openFlags,
+                  int64_t fileSize,
+                  size_t bufferSize,
+                  File::GrowthPolicy growthPolicy) noexcept
 {
-    File::open(filePath, openFlags, fileSize);
+    File::open(filePath, openFlags, fileSize, bufferSize, growthPolicy);
 }
 
 fslib::File::File(fslib::File &&file)
     : Stream(std::move(file))
     , m_handle(file.m_handle)
     , m_flags(file.m_flags)
+    , m_buffer(std::move(file.m_buffer))
+    , m_bufferSize(file.m_bufferSize)
+    , m_bufferOffset(file.m_bufferOffset)
+    , m_bufferFilled(file.m_bufferFilled)
+    , m_bufferDirty(file.m_bufferDirty)
+    , m_fileSize(file.m_fileSize)
+    , m_growthPolicy(file.m_growthPolicy)
+    , m_sizeHint(file.m_sizeHint)
+    , m_cacheKey(std::move(file.m_cacheKey))
+    , m_stats(file.m_stats)
 {
-    file.m_handle = {0};
-    file.m_flags  = 0;
+    file.m_handle       = {0};
+    file.m_flags        = 0;
+    file.m_bufferSize   = 0;
+    file.m_bufferOffset = 0;
+    file.m_bufferFilled = 0;
+    file.m_bufferDirty  = false;
+    file.m_fileSize     = 0;
+    file.m_sizeHint     = 0;
+    file.m_stats        = nullptr;
 }
 
 fslib::File &fslib::File::operator=(fslib::File &&file) noexcept
 {
+    // Make sure nothing buffered is lost before this is overwritten.
+    File::close();
+
     // Steal the parent stuff.
-    m_offset     = file.m_offset;
-    m_streamSize = file.m_streamSize;
-    m_isOpen     = file.m_isOpen;
-    m_flags      = file.m_flags;
-    m_handle     = file.m_handle;
-
-    file.m_offset     = 0;
-    file.m_streamSize = 0;
-    file.m_isOpen     = false;
-    file.m_flags      = 0;
-    file.m_handle     = {0};
+    m_offset       = file.m_offset;
+    m_streamSize   = file.m_streamSize;
+    m_isOpen       = file.m_isOpen;
+    m_flags        = file.m_flags;
+    m_handle       = file.m_handle;
+    m_buffer       = std::move(file.m_buffer);
+    m_bufferSize   = file.m_bufferSize;
+    m_bufferOffset = file.m_bufferOffset;
+    m_bufferFilled = file.m_bufferFilled;
+    m_bufferDirty  = file.m_bufferDirty;
+    m_fileSize     = file.m_fileSize;
+    m_growthPolicy = file.m_growthPolicy;
+    m_sizeHint     = file.m_sizeHint;
+    m_cacheKey     = std::move(file.m_cacheKey);
+    m_stats        = file.m_stats;
+
+    file.m_offset       = 0;
+    file.m_streamSize   = 0;
+    file.m_isOpen       = false;
+    file.m_flags        = 0;
+    file.m_handle       = {0};
+    file.m_bufferSize   = 0;
+    file.m_bufferOffset = 0;
+    file.m_bufferFilled = 0;
+    file.m_bufferDirty  = false;
+    file.m_fileSize     = 0;
+    file.m_sizeHint     = 0;
+    file.m_stats        = nullptr;
     return *this;
 }
 
 fslib::File::~File() noexcept { File::close(); }
 
-void fslib::File::open(const fslib::Path &filePath, uint32_t openFlags, int64_t fileSize) noexcept
+void fslib::File::open(const fslib::PathView &filePath,
+                       uint32_t openFlags,
+                       int64_t fileSize,
+                       size_t bufferSize,
+                       File::GrowthPolicy growthPolicy) noexcept
 {
+    trace::Scope traceScope{{.operation = trace::Operation::OPEN_FILE,
+                             .handle    = this,
+                             .offset    = fileSize,
+                             .size      = static_cast<int64_t>(bufferSize),
+                             .flags     = openFlags,
+                             .option    = static_cast<uint8_t>(growthPolicy)},
+                            filePath};
     File::close();
 
     if (!filePath.is_valid()) { return; }
 
     FsFileSystem *filesystem{};
-    const std::string_view device = filePath.get_device_name();
-    const char *path              = filePath.get_path();
-    const bool filesystemFound    = fslib::get_file_system_by_device_name(device, &filesystem);
+    fslib::PathView::Buffer pathBuffer;
+    const char *path           = filePath.get_path(pathBuffer);
+    const bool filesystemFound = fslib::get_file_system(filePath, &filesystem);
     if (!filesystemFound) { return; }
 
+    m_stats = stats::get_counters(filePath.get_device_name());
+
     const bool openCreate = (openFlags & FsOpenMode_Create); // This is a flag added to fslib to make this easier.
     const bool openWrite  = (openFlags & FsOpenMode_Write);
     const bool openAppend = (openFlags & FsOpenMode_Append);
-    if (openAppend && !openWrite) { openFlags |= FsOpenMode_Write; }
-
-    // This is needed in case FsOpenMode_Create is passed and the file already exists.
-    const bool fileNeedsDelete = openCreate && fslib::file_exists(filePath);
-    const bool fileDeleted     = fileNeedsDelete && fslib::delete_file(filePath);
-    if (fileNeedsDelete && !fileDeleted) { return; }
-
-    const bool fileNeedsCreate = openCreate && !fslib::file_exists(filePath);
-    const bool fileCreated     = fileNeedsCreate && fslib::create_file(filePath, fileSize);
-    if (fileNeedsCreate && !fileCreated) { return; }
+    if ((openCreate || openAppend) && !openWrite) { openFlags |= FsOpenMode_Write; }
 
     // We need to strip this before passing the flags to the system. It's a helper flag for fslib and the Switch doesn't like
     // it.
     openFlags &= ~FsOpenMode_Create;
 
-    const bool openError = error::occurred(fsFsOpenFile(filesystem, path, openFlags, &m_handle));
-    const bool sizeError = !openError && error::occurred(fsFileGetSize(&m_handle, &m_streamSize));
-    if (openError || sizeError) { return; }
+    if (openCreate)
+    {
+        if (!File::open_for_create(filesystem, path, openFlags, fileSize)) { return; }
+        m_streamSize = fileSize;
+    }
+    else
+    {
+        const bool openError = error::occurred(stats::open_file(m_stats, filesystem, path, openFlags, &m_handle));
+        const bool sizeError = !openError && error::occurred(fsFileGetSize(&m_handle, &m_streamSize));
+        if (openError || sizeError) { return; }
+    }
+
+    m_fileSize     = m_streamSize;
+    m_growthPolicy = growthPolicy;
+    m_sizeHint     = growthPolicy == File::GrowthPolicy::SIZE_HINT ? fileSize : 0;
+
+    // A file created with a size hint was only allocated ahead of time. There's nothing in it yet.
+    if (openCreate && m_sizeHint > 0) { m_streamSize = 0; }
 
     m_flags  = openFlags;
     m_offset = openAppend ? m_streamSize : 0;
 
+    // The buffer is kept around between opens if the size didn't change.
+    if (bufferSize != m_bufferSize) { m_buffer.reset(); }
+    m_bufferSize  = bufferSize;
+    m_bufferDirty = false;
+    File::invalidate_buffer();
+
+    // Anything cached about this path or the directories above it can't be trusted while the file is being written to.
+    if (openFlags & (FsOpenMode_Write | FsOpenMode_Append))
+    {
+        m_cacheKey = cache::make_key(filePath);
+        cache::written(m_cacheKey, -1);
+    }
+
     m_isOpen = true;
 }
 
 void fslib::File::close() noexcept
 {
     if (!m_isOpen) { return; }
+    trace::Scope traceScope{{.operation = trace::Operation::CLOSE_FILE, .handle = this}};
+    const bool flushed = File::flush_buffer();
+    const bool trimmed = File::trim_to_size();
     fsFileClose(&m_handle);
+    File::invalidate_buffer();
     m_isOpen = false;
+
+    // Anything cached while the file was open is stale now too. The size is only trusted if everything made it out.
+    if (!m_cacheKey.empty())
+    {
+        cache::written(m_cacheKey, flushed && trimmed ? m_fileSize : -1);
+        m_cacheKey.clear();
+    }
 }
 
 bool fslib::File::is_open() const noexcept { return m_isOpen; }
 
 ssize_t fslib::File::read(void *buffer, uint64_t bufferSize) noexcept
 {
-    if (!File::is_open_for_reading()) { return -1; }
+    trace::Scope traceScope{
+        {.operation = trace::Operation::READ, .handle = this, .offset = m_offset, .size = static_cast<int64_t>(bufferSize)}};
+    if (!File::is_open_for_reading() || !File::flush_buffer()) { return -1; }
+
+    // Start with whatever is already sitting in the buffer.
+    unsigned char *bufferOut = static_cast<unsigned char *>(buffer);
+    uint64_t totalRead{};
+    const size_t available = File::buffer_available();
+    if (available > 0)
+    {
+        const uint64_t copySize  = available < bufferSize ? available : bufferSize;
+        const size_t bufferIndex = m_offset - m_bufferOffset;
+        std::memcpy(bufferOut, &m_buffer[bufferIndex], copySize);
+        m_offset += copySize;
+        totalRead += copySize;
+    }
 
-    uint64_t bytesRead{};
-    const bool readError     = error::occurred(fsFileRead(&m_handle, m_offset, buffer, bufferSize, 0, &bytesRead));
-    const bool readSizeCheck = bytesRead <= bufferSize; // This check is in place from the 3DS.
-    if (readError || !readSizeCheck)
+    const uint64_t remaining = bufferSize - totalRead;
+    if (remaining == 0 || Stream::end_of_stream()) { return totalRead; }
+
+    // Large reads skip the buffer entirely. There's no point in copying twice.
+    if (remaining >= m_bufferSize)
     {
-        // This will signal failure.
-        return -1;
+        uint64_t bytesRead{};
+        const bool readError =
+            error::occurred(stats::file_read(m_stats, &m_handle, m_offset, &bufferOut[totalRead], remaining, &bytesRead));
+        const bool readSizeCheck = bytesRead <= remaining; // This check is in place from the 3DS.
+        if (readError || !readSizeCheck)
+        {
+            // This will signal failure.
+            return -1;
+        }
+        m_offset += bytesRead;
+        return totalRead + bytesRead;
     }
-    m_offset += bytesRead;
-    return bytesRead;
+
+    if (!File::fill_buffer()) { return -1; }
+
+    const size_t refilled   = File::buffer_available();
+    const uint64_t copySize = refilled < remaining ? refilled : remaining;
+    std::memcpy(&bufferOut[totalRead], m_buffer.get(), copySize);
+    m_offset += copySize;
+    return totalRead + copySize;
 }
 
 bool fslib::File::read_line(char *lineOut, size_t lineLength) noexcept
@@ -151,26 +274,90 @@ bool fslib::File::read_line(std::string &lineOut) noexcept
 
 signed char fslib::File::get_byte() noexcept
 {
-    if (!File::is_open_for_reading()) { return -1; }
+    trace::Scope traceScope{{.operation = trace::Operation::GET_BYTE, .handle = this, .offset = m_offset}};
+    if (!File::is_open_for_reading() || Stream::end_of_stream() || !File::flush_buffer()) { return -1; }
+
+    // Unbuffered files still need to go the slow way.
+    if (m_bufferSize == 0)
+    {
+        char byte{};
+        uint64_t bytesRead{};
+        const bool readError = error::occurred(stats::file_read(m_stats, &m_handle, m_offset, &byte, 1, &bytesRead));
+        if (readError || bytesRead != 1) { return -1; }
+        ++m_offset;
+        return byte;
+    }
+
+    const bool needsFill = File::buffer_available() == 0;
+    if (needsFill && (!File::fill_buffer() || File::buffer_available() == 0)) { return -1; }
+
+    const size_t bufferIndex = m_offset++ - m_bufferOffset;
+    return static_cast<signed char>(m_buffer[bufferIndex]);
+}
+
+ssize_t fslib::File::read_at(int64_t offset, void *buffer, uint64_t bufferSize) const noexcept
+{
+    trace::Scope traceScope{
+        {.operation = trace::Operation::READ_AT, .handle = this, .offset = offset, .size = static_cast<int64_t>(bufferSize)}};
+    if (!File::is_open_for_reading() || offset < 0) { return -1; }
+
+    // The handle is passed by pointer, but libnx doesn't change anything in it.
+    FsFile *handle = const_cast<FsFile *>(&m_handle);
 
-    char byte{};
     uint64_t bytesRead{};
-    const bool streamEnd = Stream::end_of_stream();
-    const bool readError = !streamEnd && error::occurred(fsFileRead(&m_handle, m_offset++, &byte, 1, 0, &bytesRead));
-    if (readError) { return -1; }
-    return byte;
+    const bool readError     = error::occurred(stats::file_read(m_stats, handle, offset, buffer, bufferSize, &bytesRead));
+    const bool readSizeCheck = bytesRead <= bufferSize;
+    if (readError || !readSizeCheck) { return -1; }
+
+    return bytesRead;
 }
 
 ssize_t fslib::File::write(const void *buffer, uint64_t bufferSize) noexcept
 {
-    const bool openForWrite = File::is_open_for_writing();
-    const bool resized      = File::resize_if_needed(bufferSize);
-    if (!openForWrite || !resized) { return -1; }
+    trace::Scope traceScope{
+        {.operation = trace::Operation::WRITE, .handle = this, .offset = m_offset, .size = static_cast<int64_t>(bufferSize)}};
+    if (!File::is_open_for_writing()) { return -1; }
+
+    // Large writes go straight to the file after whatever is pending.
+    if (bufferSize >= m_bufferSize)
+    {
+        const bool flushed = File::flush_buffer();
+        const bool resized = flushed && File::resize_if_needed(m_offset + bufferSize);
+        if (!flushed || !resized) { return -1; }
+
+        // Anything buffered could be stale after this.
+        File::invalidate_buffer();
+
+        const bool writeError = error::occurred(stats::file_write(m_stats, &m_handle, m_offset, buffer, bufferSize));
+        if (writeError) { return -1; }
+        // There's no real way to verify this was completely successful on Switch
+        m_offset += bufferSize;
+        return bufferSize;
+    }
+
+    // Read data has no business being in the buffer once writing starts.
+    if (!m_bufferDirty)
+    {
+        File::invalidate_buffer();
+        m_bufferOffset = m_offset;
+    }
+
+    const bool contiguous = m_bufferOffset + static_cast<int64_t>(m_bufferFilled) == m_offset;
+    const bool fits       = m_bufferFilled + bufferSize <= m_bufferSize;
+    if (!contiguous || !fits)
+    {
+        if (!File::flush_buffer()) { return -1; }
+        m_bufferOffset = m_offset;
+    }
+
+    if (!m_buffer) { m_buffer = std::make_unique<unsigned char[]>(m_bufferSize); }
+
+    std::memcpy(&m_buffer[m_bufferFilled], buffer, bufferSize);
+    m_bufferFilled += bufferSize;
+    m_bufferDirty = true;
 
-    const bool writeError = error::occurred(fsFileWrite(&m_handle, m_offset, buffer, bufferSize, 0));
-    if (writeError) { return -1; }
-    // There's no real way to verify this was completely successful on Switch
     m_offset += bufferSize;
+    if (m_offset > m_streamSize) { m_streamSize = m_offset; }
     return bufferSize;
 }
 
@@ -188,14 +375,8 @@ bool fslib::File::writef(const char *format, ...) noexcept
 
 bool fslib::File::put_byte(char byte) noexcept
 {
-    const bool openForWrite = File::is_open_for_writing();
-    const bool resized      = File::resize_if_needed(1); // This is funny.
-    if (!openForWrite || !resized) { return false; }
-
-    // I'm not calling another function for 1 byte.
-    const bool writeError = error::occurred(fsFileWrite(&m_handle, m_offset++, &byte, 1, 0));
-    if (writeError) { return false; }
-    return true;
+    trace::Scope traceScope{{.operation = trace::Operation::PUT_BYTE, .handle = this, .offset = m_offset}};
+    return File::write(&byte, 1) == 1;
 }
 
 fslib::File &fslib::File::operator<<(const char *string) noexcept
@@ -210,8 +391,32 @@ fslib::File &fslib::File::operator<<(const std::string &string) noexcept
     return *this;
 }
 
+ssize_t fslib::File::write_at(int64_t offset, const void *buffer, uint64_t bufferSize) noexcept
+{
+    trace::Scope traceScope{
+        {.operation = trace::Operation::WRITE_AT, .handle = this, .offset = offset, .size = static_cast<int64_t>(bufferSize)}};
+    if (!File::is_open_for_writing() || offset < 0) { return -1; }
+
+    {
+        // Only growing the file needs to be serialized. The write itself doesn't.
+        std::lock_guard<std::mutex> resizeGuard{m_resizeLock};
+        if (!File::resize_if_needed(offset + bufferSize)) { return -1; }
+    }
+
+    const bool writeError = error::occurred(stats::file_write(m_stats, &m_handle, offset, buffer, bufferSize));
+    if (writeError) { return -1; }
+
+    return bufferSize;
+}
+
 void fslib::File::seek(int64_t offset, Stream::Origin origin)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::SEEK,
+                             .handle    = this,
+                             .offset    = offset,
+                             .option    = static_cast<uint8_t>(origin)}};
+    File::flush_buffer();
+
     switch (origin)
     {
         case Stream::Origin::BEGINNING: m_offset = offset; break;
@@ -220,33 +425,132 @@ void fslib::File::seek(int64_t offset, Stream::Origin origin)
     }
 
     if (m_offset < 0) { m_offset = 0; }
-    File::resize_if_needed(0);
+    File::resize_if_needed(m_offset);
+
+    // The read buffer is tied to the offset it was filled from, so seeking inside of it doesn't require a refill. Seeking
+    // outside of it is caught by buffer_available() on the next read.
 }
 
 bool fslib::File::flush() noexcept
 {
-    if (!File::is_open_for_writing()) { return false; }
+    trace::Scope traceScope{{.operation = trace::Operation::FLUSH, .handle = this}};
+    if (!File::is_open_for_writing() || !File::flush_buffer() || !File::trim_to_size()) { return false; }
 
     const bool flushError = error::occurred(fsFileFlush(&m_handle));
     if (flushError) { return false; }
     return true;
 }
 
-bool fslib::File::resize_if_needed(int64_t bufferSize)
+bool fslib::File::open_for_create(FsFileSystem *filesystem,
+                                  const char *path,
+                                  uint32_t openFlags,
+                                  int64_t fileSize) noexcept
+{
+    // Try opening first. Failing here just means the file needs to be created, so it isn't recorded as an error.
+    const bool fileOpened = R_SUCCEEDED(stats::open_file(m_stats, filesystem, path, openFlags, &m_handle));
+    if (fileOpened)
+    {
+        // Truncating in place is far cheaper than deleting and creating the file again.
+        const bool truncateError = error::occurred(stats::file_set_size(m_stats, &m_handle, 0));
+        const bool resizeError =
+            !truncateError && fileSize > 0 && error::occurred(stats::file_set_size(m_stats, &m_handle, fileSize));
+        if (truncateError || resizeError)
+        {
+            fsFileClose(&m_handle);
+            return false;
+        }
+        return true;
+    }
+
+    const bool createError = error::occurred(fsFsCreateFile(filesystem, path, fileSize, 0));
+    const bool openError =
+        !createError && error::occurred(stats::open_file(m_stats, filesystem, path, openFlags, &m_handle));
+    if (createError || openError) { return false; }
+
+    return true;
+}
+
+bool fslib::File::fill_buffer() noexcept
+{
+    if (!m_buffer) { m_buffer = std::make_unique<unsigned char[]>(m_bufferSize); }
+
+    File::invalidate_buffer();
+
+    uint64_t bytesRead{};
+    const bool readError =
+        error::occurred(stats::file_read(m_stats, &m_handle, m_offset, m_buffer.get(), m_bufferSize, &bytesRead));
+    if (readError || bytesRead > m_bufferSize) { return false; }
+
+    m_bufferOffset = m_offset;
+    m_bufferFilled = bytesRead;
+    return true;
+}
+
+bool fslib::File::flush_buffer() noexcept
+{
+    if (!m_bufferDirty) { return true; }
+
+    // This is cleared first so a failure doesn't leave the buffer stuck trying to write the same data forever.
+    m_bufferDirty = false;
+
+    const int64_t bufferEnd = m_bufferOffset + static_cast<int64_t>(m_bufferFilled);
+    const bool resized      = File::resize_if_needed(bufferEnd);
+    const bool writeError =
+        resized && error::occurred(stats::file_write(m_stats, &m_handle, m_bufferOffset, m_buffer.get(), m_bufferFilled));
+    File::invalidate_buffer();
+    if (!resized || writeError) { return false; }
+
+    return true;
+}
+
+bool fslib::File::resize_if_needed(int64_t requiredSize)
 {
     if (!File::is_open_for_writing()) { return false; }
+    if (requiredSize <= m_fileSize)
+    {
+        if (m_streamSize < requiredSize) { m_streamSize = requiredSize; }
+        return true;
+    }
+
+    int64_t newFileSize = requiredSize;
+    switch (m_growthPolicy)
+    {
+        case File::GrowthPolicy::EXACT: break;
+
+        case File::GrowthPolicy::GEOMETRIC:
+        {
+            const int64_t growthStep = m_fileSize < GEOMETRIC_MAXIMUM_STEP ? m_fileSize : GEOMETRIC_MAXIMUM_STEP;
+            const int64_t grownSize  = m_fileSize + growthStep;
+            if (grownSize > newFileSize) { newFileSize = grownSize; }
+            if (GEOMETRIC_MINIMUM > newFileSize) { newFileSize = GEOMETRIC_MINIMUM; }
+        }
+        break;
+
+        case File::GrowthPolicy::SIZE_HINT:
+        {
+            if (m_sizeHint > newFileSize) { newFileSize = m_sizeHint; }
+        }
+        break;
+    }
+
+    // If allocating ahead fails, there might still be room for what's actually needed.
+    const bool resizeError = error::occurred(stats::file_set_size(m_stats, &m_handle, newFileSize));
+    const bool retryExact  = resizeError && newFileSize != requiredSize;
+    const bool exactError  = retryExact && error::occurred(stats::file_set_size(m_stats, &m_handle, requiredSize));
+    if ((resizeError && !retryExact) || exactError) { return false; }
 
-    const bool offsetOOB      = m_offset > m_streamSize;
-    const bool bufferTooLarge = m_offset + bufferSize > m_streamSize;
-    if (!offsetOOB && !bufferTooLarge) { return true; }
+    m_fileSize = retryExact ? requiredSize : newFileSize;
+    if (m_streamSize < requiredSize) { m_streamSize = requiredSize; }
+    return true;
+}
 
-    int64_t newFileSize{};
-    if (offsetOOB) { newFileSize = m_offset; }
-    else if (bufferTooLarge) { newFileSize = m_offset + bufferSize; }
+bool fslib::File::trim_to_size() noexcept
+{
+    if (!File::is_open_for_writing() || m_fileSize <= m_streamSize) { return true; }
 
-    const bool resizeError = error::occurred(fsFileSetSize(&m_handle, newFileSize));
-    if (resizeError) { return false; }
+    const bool trimError = error::occurred(stats::file_set_size(m_stats, &m_handle, m_streamSize));
+    if (trimError) { return false; }
 
-    m_streamSize = newFileSize;
+    m_fileSize = m_streamSize;
     return true;
 }
@@ -16,42 +16,110 @@ FsLibCore::FsLibCore()
     const bool sdmcError = fslib::error::occurred(fsOpenSdCardFileSystem(&sdmc));
     if (sdmcError) { return; }
 
-    const auto emplaced = m_deviceMap.try_emplace(SDMC_DEVICE.data(), sdmc);
-    if (!emplaced.second) { return; }
+    if (!FsLibCore::map_file_system(SDMC_DEVICE, sdmc)) { return; }
 
     m_initialized = true;
 }
 
+FsLibCore::~FsLibCore()
+{
+    std::lock_guard<std::mutex> mountGuard{m_mountLock};
+    for (auto &device : m_devices)
+    {
+        const bool mapped = device->generation.load(std::memory_order_relaxed) & 1;
+        if (mapped) { fsFsClose(&device->filesystem); }
+    }
+}
+
 bool FsLibCore::map_file_system(std::string_view deviceName, FsFileSystem &filesystem)
 {
-    const bool inUse = m_deviceMap.find(deviceName) != m_deviceMap.end();
+    std::lock_guard<std::mutex> mountGuard{m_mountLock};
+
+    const bool inUse = FsLibCore::find_mapped(deviceName) != nullptr;
     if (inUse)
     {
         fslib::error::occurred(fslib::error::codes::DEVICE_NAME_IN_USE);
         return false;
     }
 
-    const auto emplaced = m_deviceMap.try_emplace(deviceName.data(), filesystem);
-    if (!emplaced.second) { return false; }
+    // Devices are reused by name so their generation keeps counting up instead of starting over.
+    FsLibCore::Device &device = FsLibCore::get_or_add_device(deviceName);
+    device.filesystem         = filesystem;
+    device.generation.fetch_add(1, std::memory_order_release);
 
     return true;
 }
 
 bool FsLibCore::get_file_system_by_device_name(std::string_view deviceName, FsFileSystem **filesystem)
 {
-    const auto findDevice = m_deviceMap.find(deviceName);
-    if (findDevice == m_deviceMap.end()) { return false; }
+    FsLibCore::Device *device = FsLibCore::find_mapped(deviceName);
+    if (!device) { return false; }
+
+    *filesystem = &device->filesystem;
+    return true;
+}
+
+bool FsLibCore::resolve_device(std::string_view deviceName, fslib::DeviceToken &tokenOut)
+{
+    FsLibCore::Device *device = FsLibCore::find_mapped(deviceName);
+    const uint32_t generation = device ? device->generation.load(std::memory_order_acquire) : 0;
+
+    // The device could've been closed between finding it and reading the generation.
+    if (!(generation & 1))
+    {
+        tokenOut = {};
+        return false;
+    }
 
-    *filesystem = findDevice->second.get();
+    tokenOut = {.filesystem = &device->filesystem, .generation = &device->generation, .mountGeneration = generation};
     return true;
 }
 
 bool FsLibCore::close_file_system(std::string_view deviceName)
 {
-    const bool sdmcGuard  = deviceName == SDMC_DEVICE;
-    const auto findDevice = m_deviceMap.find(deviceName);
-    if (sdmcGuard || findDevice == m_deviceMap.end()) { return false; }
+    std::lock_guard<std::mutex> mountGuard{m_mountLock};
+
+    const bool sdmcGuard      = deviceName == SDMC_DEVICE;
+    FsLibCore::Device *device = FsLibCore::find_mapped(deviceName);
+    if (sdmcGuard || !device) { return false; }
 
-    m_deviceMap.erase(findDevice);
+    // The generation changes first so no token can still be current once the file system is gone.
+    device->generation.fetch_add(1, std::memory_order_release);
+    fsFsClose(&device->filesystem);
     return true;
-}
\ No newline at end of file
+}
+
+FsLibCore::Device *FsLibCore::find_mapped(std::string_view deviceName) const noexcept
+{
+    const FsLibCore::DeviceTable *deviceTable = m_deviceTable.load(std::memory_order_acquire);
+    if (!deviceTable) { return nullptr; }
+
+    const auto findDevice = deviceTable->find(deviceName);
+    if (findDevice == deviceTable->end()) { return nullptr; }
+
+    FsLibCore::Device *device = findDevice->second;
+    const bool mapped         = device->generation.load(std::memory_order_acquire) & 1;
+    return mapped ? device : nullptr;
+}
+
+FsLibCore::Device &FsLibCore::get_or_add_device(std::string_view deviceName)
+{
+    const FsLibCore::DeviceTable *deviceTable = m_deviceTable.load(std::memory_order_relaxed);
+    if (deviceTable)
+    {
+        const auto findDevice = deviceTable->find(deviceName);
+        if (findDevice != deviceTable->end()) { return *findDevice->second; }
+    }
+
+    // Copy the current table, add the new device and swap it in. Readers see either the old table or the new one.
+    auto newTable = deviceTable ? std::make_unique<FsLibCore::DeviceTable>(*deviceTable)
+                                : std::make_unique<FsLibCore::DeviceTable>();
+
+    FsLibCore::Device &device = *m_devices.emplace_back(std::make_unique<FsLibCore::Device>());
+    newTable->try_emplace(std::string{deviceName}, &device);
+
+    m_deviceTable.store(newTable.get(), std::memory_order_release);
+    m_deviceTables.push_back(std::move(newTable));
+
+    return device;
+}
@@ -1,5 +1,6 @@
 #include "Path.hpp"
 
+#include "PathView.hpp"
 #include "error.hpp"
 
 #include <cstring>
@@ -11,25 +12,28 @@ namespace
     constexpr const char *FORBIDDEN_PATH_CHARACTERS = "<>:\"|?*";
 } // namespace
 
-fslib::Path::Path()
-    : m_path(std::make_unique<char[]>(FS_MAX_PATH)) {};
+fslib::Path::Path() { m_inlinePath[0] = '\0'; }
 
 fslib::Path::Path(const fslib::Path &path)
-    : m_device(path.m_device)
-    , m_path(std::make_unique<char[]>(FS_MAX_PATH))
-    , m_offset(path.m_offset)
+    : Path()
 {
-    const char *pathData = path.m_path.get();
-    std::copy(pathData, pathData + FS_MAX_PATH, m_path.get());
+    Path::copy_from(path);
 }
 
 fslib::Path::Path(Path &&path) noexcept
     : m_device(std::move(path.m_device))
-    , m_path(std::move(path.m_path))
+    , m_deviceToken(path.m_deviceToken)
+    , m_heapPath(std::move(path.m_heapPath))
     , m_offset(path.m_offset)
 {
-    path.m_path   = std::make_unique<char[]>(FS_MAX_PATH);
-    path.m_offset = 0;
+    // Long paths just hand over their buffer. Short ones only copy what's used.
+    if (!m_heapPath) { std::copy(path.m_inlinePath, path.m_inlinePath + m_offset + 1, m_inlinePath); }
+    else { m_inlinePath[0] = '\0'; }
+
+    path.m_device.clear();
+    path.m_deviceToken   = {};
+    path.m_inlinePath[0] = '\0';
+    path.m_offset        = 0;
 }
 
 fslib::Path::Path(const char *path)
@@ -56,11 +60,28 @@ fslib::Path::Path(const std::filesystem::path &path)
     *this = path;
 }
 
+fslib::Path::Path(const fslib::PathView &path)
+    : Path()
+{
+    if (path.get_length() >= FS_MAX_PATH) { return; }
+
+    // This is where sdmc:file gets its slash.
+    fslib::PathView::Buffer pathBuffer;
+    const std::string_view pathData = path.get_path(pathBuffer);
+
+    m_device      = path.get_device_name();
+    m_deviceToken = path.get_device_token();
+    Path::reserve(pathData.length());
+    std::copy(pathData.begin(), pathData.end(), Path::get_buffer());
+    m_offset = pathData.length();
+    Path::null_terminate();
+}
+
 bool fslib::Path::is_valid() const noexcept
 {
     const bool validDevice       = !m_device.empty();
     const bool validLength       = m_offset >= 1;
-    const bool containsForbidden = std::strpbrk(m_path.get(), FORBIDDEN_PATH_CHARACTERS) != NULL;
+    const bool containsForbidden = std::strpbrk(Path::get_buffer(), FORBIDDEN_PATH_CHARACTERS) != NULL;
     if (!validDevice || !validLength || containsForbidden)
     {
         error::occurred(error::codes::INVALID_PATH);
@@ -72,24 +93,28 @@ bool fslib::Path::is_valid() const noexcept
 
 fslib::Path fslib::Path::sub_path(size_t pathLength) const
 {
-    if (pathLength > FS_MAX_PATH) { pathLength = FS_MAX_PATH; }
+    if (pathLength > m_offset) { pathLength = m_offset; }
 
     // To do: This needs to ensure a starting slash.
     fslib::Path newPath{};
-    newPath.m_device = m_device;
+    newPath.m_device      = m_device;
+    newPath.m_deviceToken = m_deviceToken;
+    newPath.reserve(pathLength);
     newPath.m_offset = pathLength;
 
-    const char *path = m_path.get();
-    std::copy(path, path + pathLength, newPath.m_path.get());
+    const char *path = Path::get_buffer();
+    std::copy(path, path + pathLength, newPath.get_buffer());
+    newPath.null_terminate();
 
     return newPath;
 }
 
 size_t fslib::Path::find_first_of(char character) const noexcept
 {
+    const char *path = Path::get_buffer();
     for (size_t i = 0; i < m_offset; i++)
     {
-        if (m_path[i] == character) { return i; }
+        if (path[i] == character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -97,11 +122,12 @@ size_t fslib::Path::find_first_of(char character) const noexcept
 
 size_t fslib::Path::find_first_of(char character, size_t begin) const noexcept
 {
+    const char *path = Path::get_buffer();
     if (begin >= m_offset) { return Path::NOT_FOUND; }
 
     for (size_t i = begin; i < m_offset; i++)
     {
-        if (m_path[i] == character) { return i; }
+        if (path[i] == character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -109,9 +135,10 @@ size_t fslib::Path::find_first_of(char character, size_t begin) const noexcept
 
 size_t fslib::Path::find_first_not_of(char character) const noexcept
 {
+    const char *path = Path::get_buffer();
     for (size_t i = 0; i < m_offset; i++)
     {
-        if (m_path[i] != character) { return i; }
+        if (path[i] != character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -119,11 +146,12 @@ size_t fslib::Path::find_first_not_of(char character) const noexcept
 
 size_t fslib::Path::find_first_not_of(char character, size_t begin) const noexcept
 {
+    const char *path = Path::get_buffer();
     if (begin >= m_offset) { return Path::NOT_FOUND; }
 
     for (size_t i = begin; i < m_offset; i++)
     {
-        if (m_path[i] != character) { return i; }
+        if (path[i] != character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -131,9 +159,10 @@ size_t fslib::Path::find_first_not_of(char character, size_t begin) const noexce
 
 size_t fslib::Path::find_last_of(char character) const noexcept
 {
+    const char *path = Path::get_buffer();
     for (size_t i = m_offset; i-- > 0;)
     {
-        if (m_path[i] == character) { return i; }
+        if (path[i] == character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -141,11 +170,12 @@ size_t fslib::Path::find_last_of(char character) const noexcept
 
 size_t fslib::Path::find_last_of(char character, size_t begin) const noexcept
 {
+    const char *path = Path::get_buffer();
     if (begin > m_offset) { begin = m_offset; }
 
     for (size_t i = begin; i-- > 0;)
     {
-        if (m_path[i] == character) { return i; }
+        if (path[i] == character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -153,9 +183,10 @@ size_t fslib::Path::find_last_of(char character, size_t begin) const noexcept
 
 size_t fslib::Path::find_last_not_of(char character) const noexcept
 {
+    const char *path = Path::get_buffer();
     for (size_t i = m_offset; i-- > 0;)
     {
-        if (m_path[i] != character) { return i; }
+        if (path[i] != character) { return i; }
     }
 
     return Path::NOT_FOUND;
@@ -163,28 +194,31 @@ size_t fslib::Path::find_last_not_of(char character) const noexcept
 
 size_t fslib::Path::find_last_not_of(char character, size_t begin) const noexcept
 {
+    const char *path = Path::get_buffer();
     if (begin >= m_offset) { begin = m_offset; }
 
     for (size_t i = m_offset; i-- > 0;)
     {
-        if (m_path[i] != character) { return i; }
+        if (path[i] != character) { return i; }
     }
 
     return Path::NOT_FOUND;
 }
 
-std::string fslib::Path::string() const { return m_device + ":" + m_path.get(); }
+std::string fslib::Path::string() const { return m_device + ":" + Path::get_buffer(); }
 
 std::string_view fslib::Path::get_device_name() const noexcept { return m_device; }
 
-const char *fslib::Path::get_path() const { return m_path.get(); }
+const fslib::DeviceToken &fslib::Path::get_device_token() const noexcept { return m_deviceToken; }
+
+const char *fslib::Path::get_path() const noexcept { return Path::get_buffer(); }
 
 const char *fslib::Path::get_filename() const noexcept
 {
     size_t lastSlash = Path::find_last_of('/');
     if (lastSlash == Path::NOT_FOUND) { return nullptr; }
     // This could be dangerous. To do: Fix that.
-    return &m_path[lastSlash + 1];
+    return &Path::get_buffer()[lastSlash + 1];
 }
 
 const char *fslib::Path::get_extension() const noexcept
@@ -192,32 +226,33 @@ const char *fslib::Path::get_extension() const noexcept
     size_t extensionBegin = Path::find_last_of('.');
     if (extensionBegin == Path::NOT_FOUND) { return nullptr; }
     // To do: This is not safe.
-    return &m_path[extensionBegin + 1];
+    return &Path::get_buffer()[extensionBegin + 1];
 }
 
 size_t fslib::Path::get_length() const noexcept { return m_offset; }
 
 fslib::Path &fslib::Path::operator=(const fslib::Path &path)
 {
-    m_device = path.m_device;
-    m_offset = path.m_offset;
-
-    const char *pathData = path.m_path.get();
-    std::copy(pathData, pathData + FS_MAX_PATH, m_path.get());
+    if (this != &path) { Path::copy_from(path); }
 
     return *this;
 }
 
 fslib::Path &fslib::Path::operator=(fslib::Path &&path) noexcept
 {
-    m_device = std::move(path.m_device);
-    m_path   = std::move(path.m_path);
-    m_offset = path.m_offset;
+    if (this == &path) { return *this; }
+
+    m_device      = std::move(path.m_device);
+    m_deviceToken = path.m_deviceToken;
+    m_heapPath    = std::move(path.m_heapPath);
+    m_offset      = path.m_offset;
+    if (!m_heapPath) { std::copy(path.m_inlinePath, path.m_inlinePath + m_offset + 1, m_inlinePath); }
 
     // Just in case.
     path.m_device.clear();
-    path.m_path   = std::make_unique<char[]>(FS_MAX_PATH);
-    path.m_offset = 0;
+    path.m_deviceToken   = {};
+    path.m_inlinePath[0] = '\0';
+    path.m_offset        = 0;
 
     return *this;
 }
@@ -231,10 +266,15 @@ fslib::Path &fslib::Path::operator=(std::string_view path)
     const size_t deviceEnd = path.find_first_of(':');
     if (deviceEnd == path.npos) { return *this; }
 
+    char *buffer            = Path::get_buffer();
     m_offset                = 0;
-    m_path[m_offset++]      = '/'; // Ensure this starts with a slash.
+    buffer[m_offset++]      = '/'; // Ensure this starts with a slash.
     m_device                = path.substr(0, deviceEnd);
     std::string_view fsPath = path.substr(deviceEnd + 1);
+    Path::null_terminate();
+
+    // This can fail if the device isn't mapped yet. Operations will just search for it instead.
+    fslib::resolve_device(m_device, m_deviceToken);
 
     const size_t pathBegin = fsPath.find_first_not_of('/');
     const size_t pathEnd   = fsPath.find_last_not_of('/');
@@ -243,9 +283,10 @@ fslib::Path &fslib::Path::operator=(std::string_view path)
     const size_t fsPathLength = (pathEnd - pathBegin) + 1;
     if (fsPathLength + 1 >= FS_MAX_PATH) { return *this; }
 
+    Path::reserve(fsPathLength + 1);
     fsPath               = fsPath.substr(pathBegin);
     const char *pathData = fsPath.data();
-    std::copy(pathData, pathData + fsPathLength, &m_path[m_offset]);
+    std::copy(pathData, pathData + fsPathLength, &Path::get_buffer()[m_offset]);
     m_offset += fsPathLength;
     Path::null_terminate();
 
@@ -272,12 +313,14 @@ fslib::Path &fslib::Path::operator/=(std::string_view path) noexcept
     if (m_offset + length + 1 >= FS_MAX_PATH) { return *this; }
 
     // Needed to avoid doubling up slashes directly appending to a device root.
-    if (m_path[m_offset - 1] != '/') { m_path[m_offset++] = '/'; }
+    Path::reserve(m_offset + length + 1);
+    char *buffer = Path::get_buffer();
+    if (m_offset == 0 || buffer[m_offset - 1] != '/') { buffer[m_offset++] = '/'; }
 
     // This looks really dangerous for some reason. I like it though.
     const std::string_view slice = path.substr(pathBegin);
     const char *pathData         = slice.data();
-    std::copy(pathData, pathData + length, &m_path[m_offset]);
+    std::copy(pathData, pathData + length, &buffer[m_offset]);
     m_offset += length;
     Path::null_terminate();
 
@@ -303,8 +346,9 @@ fslib::Path &fslib::Path::operator+=(std::string_view path) noexcept
     const size_t length = path.length();
     if (m_offset + length >= FS_MAX_PATH) { return *this; }
 
+    Path::reserve(m_offset + length);
     const char *pathData = path.data();
-    std::copy(pathData, pathData + length, &m_path[m_offset]);
+    std::copy(pathData, pathData + length, &Path::get_buffer()[m_offset]);
     m_offset += length;
     Path::null_terminate();
 
@@ -321,7 +365,31 @@ fslib::Path &fslib::Path::operator+=(const fslib::DirectoryEntry &path) noexcept
     return *this += std::string_view(path.get_filename());
 }
 
-void fslib::Path::null_terminate() noexcept { m_path[m_offset] = '\0'; }
+char *fslib::Path::get_buffer() noexcept { return m_heapPath ? m_heapPath.get() : m_inlinePath; }
+
+const char *fslib::Path::get_buffer() const noexcept { return m_heapPath ? m_heapPath.get() : m_inlinePath; }
+
+void fslib::Path::reserve(size_t length)
+{
+    if (m_heapPath || length < INLINE_PATH_SIZE) { return; }
+
+    // Once a path is on the heap it stays there. Anything that gets this long is probably going to again.
+    m_heapPath = std::make_unique<char[]>(FS_MAX_PATH);
+    std::copy(m_inlinePath, m_inlinePath + m_offset + 1, m_heapPath.get());
+}
+
+void fslib::Path::copy_from(const Path &path)
+{
+    m_device      = path.m_device;
+    m_deviceToken = path.m_deviceToken;
+    Path::reserve(path.m_offset);
+    m_offset = path.m_offset;
+
+    const char *pathData = path.get_buffer();
+    std::copy(pathData, pathData + m_offset + 1, Path::get_buffer());
+}
+
+void fslib::Path::null_terminate() noexcept { Path::get_buffer()[m_offset] = '\0'; }
 
 fslib::Path fslib::operator/(const fslib::Path &pathA, const char *pathB)
 {
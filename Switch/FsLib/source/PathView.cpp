@@ -0,0 +1,137 @@
+#include "PathView.hpp"
+
+#include "error.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    constexpr std::string_view FORBIDDEN_PATH_CHARACTERS = "<>:\"|?*";
+
+    /// @brief FORBIDDEN_PATH_CHARACTERS as a table. Every Path passed as a view is checked, so this needs to be one lookup per
+    /// character instead of a search of the set for each one.
+    constexpr std::array<bool, 0x100> FORBIDDEN_TABLE = []() {
+        std::array<bool, 0x100> table{};
+        for (const char character : FORBIDDEN_PATH_CHARACTERS) { table[static_cast<unsigned char>(character)] = true; }
+        return table;
+    }();
+
+    /// @brief This is used for device roots that don't have a slash to point to. Literals are NULL terminated.
+    constexpr std::string_view ROOT_PATH = "/";
+} // namespace
+
+/// @brief Runs the same checks as Path::is_valid on a device and path.
+static bool check_path(std::string_view device, std::string_view path, bool missingSlash) noexcept;
+
+fslib::PathView::PathView(const fslib::Path &path) noexcept
+    : m_device(path.get_device_name())
+    , m_path(path.get_path(), path.get_length())
+    , m_deviceToken(path.get_device_token())
+    , m_terminated(true)
+{
+    m_valid = check_path(m_device, m_path, false);
+}
+
+fslib::PathView::PathView(const char *path) noexcept { PathView::parse(path ? path : std::string_view{}, true); }
+
+fslib::PathView::PathView(const std::string &path) noexcept { PathView::parse(path, true); }
+
+fslib::PathView::PathView(std::string_view path) noexcept { PathView::parse(path, false); }
+
+bool fslib::PathView::is_valid() const noexcept
+{
+    if (!m_valid) { error::occurred(error::codes::INVALID_PATH); }
+
+    return m_valid;
+}
+
+fslib::PathView fslib::PathView::sub_path(size_t pathLength) const noexcept
+{
+    if (pathLength > m_path.length()) { pathLength = m_path.length(); }
+
+    PathView subPath{*this};
+    subPath.m_path       = m_path.substr(0, pathLength);
+    subPath.m_terminated = m_terminated && pathLength == m_path.length();
+    subPath.m_valid      = m_valid && pathLength > 0;
+
+    return subPath;
+}
+
+std::string_view fslib::PathView::get_device_name() const noexcept { return m_device; }
+
+const fslib::DeviceToken &fslib::PathView::get_device_token() const noexcept { return m_deviceToken; }
+
+std::string_view fslib::PathView::get_path() const noexcept { return m_path; }
+
+const char *fslib::PathView::get_path(PathView::Buffer &buffer) const noexcept
+{
+    if (m_terminated && !m_missingSlash) { return m_path.data(); }
+
+    // Paths like sdmc:file get the slash the Switch's FS expects here.
+    size_t offset{};
+    if (m_missingSlash) { buffer[offset++] = '/'; }
+
+    // Valid paths always fit. This is just so an invalid one can't write past the end.
+    const size_t length = std::min(m_path.length(), buffer.size() - offset - 1);
+    std::copy(m_path.begin(), m_path.begin() + length, buffer.begin() + offset);
+    buffer[offset + length] = '\0';
+
+    return buffer.data();
+}
+
+size_t fslib::PathView::get_length() const noexcept { return m_path.length(); }
+
+std::string fslib::PathView::string() const
+{
+    std::string path{m_device};
+    path += ':';
+    if (m_missingSlash) { path += '/'; }
+    path += m_path;
+    return path;
+}
+
+void fslib::PathView::parse(std::string_view path, bool terminated) noexcept
+{
+    const size_t deviceEnd = path.find_first_of(':');
+    if (deviceEnd == path.npos) { return; }
+
+    m_device                      = path.substr(0, deviceEnd);
+    const std::string_view fsPath = path.substr(deviceEnd + 1);
+
+    // This is the same cleanup Path does, but the view can only be narrowed. A path that doesn't start with a slash is given
+    // one when it's copied out.
+    const size_t pathBegin = fsPath.find_first_not_of('/');
+    const size_t pathEnd   = fsPath.find_last_not_of('/');
+    if (pathBegin == fsPath.npos)
+    {
+        m_path       = ROOT_PATH;
+        m_terminated = true;
+    }
+    else if (pathBegin > 0)
+    {
+        const size_t length = (pathEnd - pathBegin) + 2;
+        m_path              = fsPath.substr(pathBegin - 1, length);
+        m_terminated        = terminated && pathEnd + 1 == fsPath.length();
+    }
+    else
+    {
+        m_path         = fsPath.substr(0, pathEnd + 1);
+        m_terminated   = terminated && pathEnd + 1 == fsPath.length();
+        m_missingSlash = true;
+    }
+
+    m_valid = check_path(m_device, m_path, m_missingSlash);
+}
+
+static bool check_path(std::string_view device, std::string_view path, bool missingSlash) noexcept
+{
+    const size_t fullLength      = missingSlash ? path.length() + 1 : path.length();
+    const bool validDevice       = !device.empty();
+    const bool validLength       = !path.empty() && fullLength < FS_MAX_PATH;
+    const bool containsForbidden = std::any_of(path.begin(), path.end(), [](char character) {
+        return FORBIDDEN_TABLE[static_cast<unsigned char>(character)];
+    });
+
+    return validDevice && validLength && !containsForbidden;
+}
@@ -0,0 +1,200 @@
+#include "SequentialReader.hpp"
+
+#include <cstring>
+
+namespace
+{
+    // Anything less than this and the thread can't read while the caller holds a chunk.
+    constexpr int MINIMUM_CHUNK_COUNT = 2;
+
+    // Empty chunks never move the offset, so the thread would never reach the end.
+    constexpr size_t MINIMUM_CHUNK_SIZE = 1;
+} // namespace
+
+fslib::SequentialReader::SequentialReader(const fslib::File &file, size_t chunkSize, int chunkCount)
+{
+    SequentialReader::open(file, chunkSize, chunkCount);
+}
+
+fslib::SequentialReader::SequentialReader(const fslib::Storage &storage, size_t chunkSize, int chunkCount)
+{
+    SequentialReader::open(storage, chunkSize, chunkCount);
+}
+
+fslib::SequentialReader::~SequentialReader() { SequentialReader::close(); }
+
+void fslib::SequentialReader::open(const fslib::File &file, size_t chunkSize, int chunkCount)
+{
+    SequentialReader::close();
+    if (!file.is_open()) { return; }
+
+    m_file = &file;
+    SequentialReader::start(file.tell(), file.get_size(), chunkSize, chunkCount);
+}
+
+void fslib::SequentialReader::open(const fslib::Storage &storage, size_t chunkSize, int chunkCount)
+{
+    SequentialReader::close();
+    if (!storage.is_open()) { return; }
+
+    m_storage = &storage;
+    SequentialReader::start(storage.tell(), storage.get_size(), chunkSize, chunkCount);
+}
+
+void fslib::SequentialReader::close() noexcept
+{
+    {
+        std::lock_guard<std::mutex> chunkGuard{m_chunkLock};
+        m_stop = true;
+    }
+    m_chunkCondition.notify_all();
+    if (m_thread.joinable()) { m_thread.join(); }
+
+    m_file          = nullptr;
+    m_storage       = nullptr;
+    m_chunksReady   = 0;
+    m_readIndex     = 0;
+    m_holdingChunk  = false;
+    m_chunkPosition = 0;
+    m_chunkLength   = 0;
+    m_isOpen        = false;
+}
+
+bool fslib::SequentialReader::is_open() const noexcept { return m_isOpen; }
+
+ssize_t fslib::SequentialReader::next_chunk(const void **chunkOut)
+{
+    const ssize_t chunkSize = SequentialReader::take_chunk(chunkOut);
+    if (chunkSize <= 0) { return chunkSize; }
+
+    // The caller gets the whole thing, so read() has nothing left to copy from it.
+    m_chunkPosition = m_chunkLength;
+    m_offset += chunkSize;
+    return chunkSize;
+}
+
+ssize_t fslib::SequentialReader::read(void *buffer, uint64_t bufferSize)
+{
+    unsigned char *bufferOut = static_cast<unsigned char *>(buffer);
+    uint64_t totalRead{};
+    while (totalRead < bufferSize)
+    {
+        if (m_chunkPosition >= m_chunkLength)
+        {
+            const void *chunk{};
+            const ssize_t chunkSize = SequentialReader::take_chunk(&chunk);
+            if (chunkSize < 0) { return -1; }
+            else if (chunkSize == 0) { break; }
+        }
+
+        const unsigned char *chunkData = m_chunks[m_readIndex].data.get();
+        const size_t available         = m_chunkLength - m_chunkPosition;
+        const uint64_t remaining       = bufferSize - totalRead;
+        const uint64_t copySize        = available < remaining ? available : remaining;
+        std::memcpy(&bufferOut[totalRead], &chunkData[m_chunkPosition], copySize);
+        m_chunkPosition += copySize;
+        m_offset += copySize;
+        totalRead += copySize;
+    }
+    return totalRead;
+}
+
+int64_t fslib::SequentialReader::tell() const noexcept { return m_offset; }
+
+int64_t fslib::SequentialReader::get_size() const noexcept { return m_endOffset; }
+
+bool fslib::SequentialReader::end_of_stream() const noexcept { return m_offset >= m_endOffset; }
+
+void fslib::SequentialReader::start(int64_t startOffset, int64_t endOffset, size_t chunkSize, int chunkCount)
+{
+    if (chunkCount < MINIMUM_CHUNK_COUNT) { chunkCount = MINIMUM_CHUNK_COUNT; }
+    if (chunkSize < MINIMUM_CHUNK_SIZE) { chunkSize = MINIMUM_CHUNK_SIZE; }
+
+    // Chunks are kept around if the reader is reopened with the same layout.
+    const bool reallocate = !m_chunks || chunkSize != m_chunkSize || chunkCount != m_chunkCount;
+    if (reallocate)
+    {
+        m_chunks = std::make_unique<Chunk[]>(chunkCount);
+        for (int i = 0; i < chunkCount; i++) { m_chunks[i].data = std::make_unique<unsigned char[]>(chunkSize); }
+    }
+
+    m_chunkSize  = chunkSize;
+    m_chunkCount = chunkCount;
+    m_offset     = startOffset;
+    m_endOffset  = endOffset;
+    m_stop       = false;
+    m_thread     = std::thread(&SequentialReader::read_ahead, this, startOffset);
+    m_isOpen     = true;
+}
+
+ssize_t fslib::SequentialReader::take_chunk(const void **chunkOut)
+{
+    if (!m_isOpen) { return -1; }
+
+    std::unique_lock<std::mutex> chunkGuard{m_chunkLock};
+
+    // Hand the last chunk back to the thread first.
+    if (m_holdingChunk)
+    {
+        m_readIndex    = (m_readIndex + 1) % m_chunkCount;
+        m_holdingChunk = false;
+        --m_chunksReady;
+        m_chunkCondition.notify_all();
+    }
+
+    m_chunkPosition = 0;
+    m_chunkLength   = 0;
+    if (SequentialReader::end_of_stream()) { return 0; }
+
+    m_chunkCondition.wait(chunkGuard, [this]() { return m_chunksReady > 0; });
+
+    // The thread stops after a failed or empty read. The chunk is left marked as ready so every call after this ends the
+    // same way.
+    const Chunk &chunk = m_chunks[m_readIndex];
+    if (chunk.size <= 0) { return chunk.size; }
+
+    m_holdingChunk = true;
+    m_chunkLength  = chunk.size;
+    *chunkOut      = chunk.data.get();
+    return chunk.size;
+}
+
+void fslib::SequentialReader::read_ahead(int64_t startOffset)
+{
+    int64_t readOffset{startOffset};
+    int writeIndex{};
+    while (readOffset < m_endOffset)
+    {
+        {
+            std::unique_lock<std::mutex> chunkGuard{m_chunkLock};
+            m_chunkCondition.wait(chunkGuard, [this]() { return m_stop || m_chunksReady < m_chunkCount; });
+            if (m_stop) { return; }
+        }
+
+        // The chunk at writeIndex isn't ready, so the caller won't touch it. There's no need to hold the lock to read.
+        Chunk &chunk            = m_chunks[writeIndex];
+        const int64_t left      = m_endOffset - readOffset;
+        const size_t readSize   = left < static_cast<int64_t>(m_chunkSize) ? left : m_chunkSize;
+        const ssize_t bytesRead = SequentialReader::read_source(readOffset, chunk.data.get(), readSize);
+
+        {
+            std::lock_guard<std::mutex> chunkGuard{m_chunkLock};
+            chunk.size = bytesRead;
+            ++m_chunksReady;
+        }
+        m_chunkCondition.notify_all();
+
+        // A short file or a failure ends things here. A failed chunk is passed along so the caller knows about it.
+        if (bytesRead <= 0) { return; }
+
+        readOffset += bytesRead;
+        writeIndex = (writeIndex + 1) % m_chunkCount;
+    }
+}
+
+ssize_t fslib::SequentialReader::read_source(int64_t offset, void *buffer, size_t bufferSize) const
+{
+    if (m_file) { return m_file->read_at(offset, buffer, bufferSize); }
+    else if (m_storage) { return m_storage->read_at(offset, buffer, bufferSize); }
+    return -1;
+}
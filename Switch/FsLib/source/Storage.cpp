@@ -49,3 +49,19 @@ signed char fslib::Storage::read_byte()
 
     return byte;
 }
+
+ssize_t fslib::Storage::read_at(int64_t offset, void *buffer, size_t bufferSize) const
+{
+    if (!m_isOpen || offset < 0 || offset >= m_streamSize) { return -1; }
+
+    // The handle is passed by pointer, but libnx doesn't change anything in it.
+    FsStorage *handle = const_cast<FsStorage *>(&m_storageHandle);
+
+    int64_t sBufferSize    = bufferSize;
+    const bool validBounds = offset + sBufferSize <= m_streamSize;
+    sBufferSize            = validBounds ? sBufferSize : m_streamSize - offset;
+    const bool readError   = error::occurred(fsStorageRead(handle, offset, buffer, sBufferSize));
+    if (readError) { return -1; }
+
+    return sBufferSize;
+}
@@ -0,0 +1,101 @@
+#include "WorkerPool.hpp"
+
+WorkerPool::WorkerPool(int threadCount)
+    : m_threadCount(threadCount < 1 ? 1 : threadCount)
+{
+    m_queues = std::make_unique<WorkerQueue[]>(m_threadCount);
+
+    m_threads.reserve(m_threadCount);
+    for (int i = 0; i < m_threadCount; i++) { m_threads.emplace_back(&WorkerPool::worker, this, i); }
+}
+
+WorkerPool::~WorkerPool()
+{
+    WorkerPool::wait();
+
+    {
+        std::lock_guard<std::mutex> stateGuard{m_stateLock};
+        m_stop = true;
+    }
+    m_stateCondition.notify_all();
+
+    for (std::thread &thread : m_threads) { thread.join(); }
+}
+
+void WorkerPool::push(WorkerPool::Task task)
+{
+    // These are counted first so wait() can't see zero while a task is on its way into a queue.
+    int queueIndex{};
+    {
+        std::lock_guard<std::mutex> stateGuard{m_stateLock};
+        queueIndex  = m_nextQueue;
+        m_nextQueue = (m_nextQueue + 1) % m_threadCount;
+        ++m_queued;
+        ++m_pending;
+    }
+
+    {
+        WorkerQueue &queue = m_queues[queueIndex];
+        std::lock_guard<std::mutex> queueGuard{queue.lock};
+        queue.tasks.push_back(std::move(task));
+    }
+    m_stateCondition.notify_all();
+}
+
+void WorkerPool::wait()
+{
+    std::unique_lock<std::mutex> stateGuard{m_stateLock};
+    m_stateCondition.wait(stateGuard, [this]() { return m_pending == 0; });
+}
+
+void WorkerPool::worker(int index)
+{
+    while (true)
+    {
+        WorkerPool::Task task{};
+        if (WorkerPool::take_task(index, task))
+        {
+            {
+                std::lock_guard<std::mutex> stateGuard{m_stateLock};
+                --m_queued;
+            }
+
+            task();
+
+            std::lock_guard<std::mutex> stateGuard{m_stateLock};
+            if (--m_pending == 0) { m_stateCondition.notify_all(); }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> stateGuard{m_stateLock};
+        m_stateCondition.wait(stateGuard, [this]() { return m_stop || m_queued > 0; });
+        if (m_stop && m_queued == 0) { return; }
+    }
+}
+
+bool WorkerPool::take_task(int index, WorkerPool::Task &taskOut)
+{
+    {
+        WorkerQueue &ownQueue = m_queues[index];
+        std::lock_guard<std::mutex> queueGuard{ownQueue.lock};
+        if (!ownQueue.tasks.empty())
+        {
+            taskOut = std::move(ownQueue.tasks.back());
+            ownQueue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int i = 1; i < m_threadCount; i++)
+    {
+        WorkerQueue &victim = m_queues[(index + i) % m_threadCount];
+        std::lock_guard<std::mutex> queueGuard{victim.lock};
+        if (!victim.tasks.empty())
+        {
+            taskOut = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,393 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    /// @brief Metadata cached for a single device. Keys are the path without the device.
+    typedef struct
+    {
+            /// @brief Every path something is known about.
+            std::unordered_map<std::string, fslib::cache::Metadata> records;
+
+            /// @brief Directories whose full contents are in records.
+            std::unordered_set<std::string> listed;
+
+            /// @brief Whether or not the device ignores case in names. Keys are folded to lower case if it does.
+            bool ignoreCase;
+    } DeviceMetadata;
+
+    /// @brief Protects the size cache.
+    std::mutex s_sizeLock{};
+
+    /// @brief Cached directory sizes.
+    std::unordered_map<std::string, int64_t> s_directorySizes{};
+
+    /// @brief Number of known directories kept before they're all dropped.
+    constexpr size_t MAX_KNOWN_DIRECTORIES = 0x2000;
+
+    /// @brief Protects the known directories.
+    std::mutex s_knownLock{};
+
+    /// @brief Keys of directories known to exist. These are only kept for devices with the metadata cache on. Anywhere else,
+    /// a directory removed outside of fslib would still be treated as existing.
+    std::unordered_set<std::string> s_knownDirectories{};
+
+    /// @brief Protects the metadata cache.
+    std::mutex s_metadataLock{};
+
+    /// @brief Metadata for each device it's enabled for.
+    std::unordered_map<std::string, DeviceMetadata> s_deviceMetadata{};
+
+    /// @brief Result returned when nothing exists at a path.
+    constexpr Result RESULT_PATH_NOT_FOUND = MAKERESULT(Module_Fs, 1);
+} // namespace
+
+/// @brief Returns whether the path at keyA is the path at keyB or is one of its parents.
+static bool contains_key(std::string_view keyA, std::string_view keyB);
+
+/// @brief Returns the parent of the path passed. Empty for the root.
+static std::string_view parent_of(std::string_view path);
+
+/// @brief Drops every cached directory size that could include the key passed.
+static void invalidate_sizes(std::string_view key);
+
+/// @brief Forgets the known directory at key and everything under it.
+static void forget_directories(std::string_view key);
+
+/// @brief Removes everything under path from the device's records.
+static void erase_children(DeviceMetadata &metadata, std::string_view path);
+
+/// @brief Returns the metadata for the device if it's enabled. The metadata lock must be held.
+static DeviceMetadata *find_device(std::string_view deviceName);
+
+/// @brief Returns the key records and listings use for path on the device passed.
+static std::string record_key(const DeviceMetadata &metadata, std::string_view path);
+
+std::string fslib::cache::make_key(const fslib::PathView &path)
+{
+    fslib::PathView::Buffer pathBuffer;
+    std::string key{path.get_device_name()};
+    key += ':';
+    key += path.get_path(pathBuffer);
+    return key;
+}
+
+bool fslib::cache::get_directory_size(const fslib::PathView &directoryPath, int64_t &sizeOut)
+{
+    const std::string key = cache::make_key(directoryPath);
+
+    std::lock_guard<std::mutex> sizeGuard{s_sizeLock};
+    const auto findSize = s_directorySizes.find(key);
+    if (findSize == s_directorySizes.end()) { return false; }
+
+    sizeOut = findSize->second;
+    return true;
+}
+
+void fslib::cache::set_directory_size(const fslib::PathView &directoryPath, int64_t size)
+{
+    std::string key = cache::make_key(directoryPath);
+
+    std::lock_guard<std::mutex> sizeGuard{s_sizeLock};
+    s_directorySizes[std::move(key)] = size;
+}
+
+void fslib::cache::clear_directory_sizes()
+{
+    std::lock_guard<std::mutex> sizeGuard{s_sizeLock};
+    s_directorySizes.clear();
+}
+
+bool fslib::cache::directory_known(std::string_view key)
+{
+    std::lock_guard<std::mutex> knownGuard{s_knownLock};
+    return s_knownDirectories.contains(std::string{key});
+}
+
+void fslib::cache::add_known_directory(std::string_view key)
+{
+    std::lock_guard<std::mutex> knownGuard{s_knownLock};
+    if (s_knownDirectories.size() >= MAX_KNOWN_DIRECTORIES) { s_knownDirectories.clear(); }
+
+    s_knownDirectories.emplace(key);
+}
+
+void fslib::cache::clear_known_directories()
+{
+    std::lock_guard<std::mutex> knownGuard{s_knownLock};
+    s_knownDirectories.clear();
+}
+
+void fslib::cache::set_metadata_enabled(std::string_view deviceName, bool enabled, bool ignoreCase)
+{
+    std::string prefix{deviceName};
+    prefix += ':';
+
+    {
+        std::lock_guard<std::mutex> knownGuard{s_knownLock};
+        std::erase_if(s_knownDirectories, [&](const std::string &known) { return known.starts_with(prefix); });
+    }
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    s_deviceMetadata.erase(std::string{deviceName});
+    if (enabled) { s_deviceMetadata.try_emplace(std::string{deviceName}).first->second.ignoreCase = ignoreCase; }
+}
+
+bool fslib::cache::metadata_enabled(std::string_view deviceName)
+{
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    return find_device(deviceName) != nullptr;
+}
+
+bool fslib::cache::get_metadata(const fslib::PathView &path, cache::Metadata &metadataOut)
+{
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(path.get_device_name());
+    if (!metadata) { return false; }
+
+    fslib::PathView::Buffer pathBuffer;
+    const std::string pathString = record_key(*metadata, path.get_path(pathBuffer));
+    const auto findRecord        = metadata->records.find(pathString);
+    if (findRecord != metadata->records.end())
+    {
+        metadataOut = findRecord->second;
+        return true;
+    }
+
+    // Only ASCII is folded. The file system folds more than that, so names outside of it can't be ruled out.
+    const bool folded = !metadata->ignoreCase || std::none_of(pathString.begin(), pathString.end(), [](char character) {
+        return static_cast<unsigned char>(character) >= 0x80;
+    });
+
+    // Anything missing from a complete listing of its parent doesn't exist.
+    const std::string_view parent = parent_of(pathString);
+    if (!folded || parent.empty() || !metadata->listed.contains(std::string{parent})) { return false; }
+
+    metadataOut = {.exists = false, .type = FsDirEntryType_File, .size = -1};
+    return true;
+}
+
+void fslib::cache::set_metadata(const fslib::PathView &path, const cache::Metadata &metadata)
+{
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *deviceMetadata = find_device(path.get_device_name());
+    if (!deviceMetadata) { return; }
+
+    fslib::PathView::Buffer pathBuffer;
+    deviceMetadata->records[record_key(*deviceMetadata, path.get_path(pathBuffer))] = metadata;
+}
+
+bool fslib::cache::query_metadata(FsFileSystem *filesystem, const fslib::PathView &path, cache::Metadata &metadataOut)
+{
+    if (cache::get_metadata(path, metadataOut)) { return true; }
+
+    // One call answers both existence checks, so the result can be cached no matter which one asked.
+    FsDirEntryType entryType{};
+    fslib::PathView::Buffer pathBuffer;
+    const Result typeResult = fsFsGetEntryType(filesystem, path.get_path(pathBuffer), &entryType);
+    const bool notFound     = R_FAILED(typeResult) && R_VALUE(typeResult) == RESULT_PATH_NOT_FOUND;
+    if (R_FAILED(typeResult) && !notFound) { return false; }
+
+    metadataOut = {.exists = !notFound, .type = entryType, .size = -1};
+    cache::set_metadata(path, metadataOut);
+    return true;
+}
+
+void fslib::cache::add_listing(const fslib::PathView &directoryPath, const fslib::Directory &directory)
+{
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(directoryPath.get_device_name());
+    if (!metadata) { return; }
+
+    fslib::PathView::Buffer pathBuffer;
+    std::string pathString      = record_key(*metadata, directoryPath.get_path(pathBuffer));
+    std::string directoryString = pathString;
+    if (directoryString.back() != '/') { directoryString += '/'; }
+
+    std::string entryPath{};
+    for (const fslib::DirectoryEntry &entry : directory)
+    {
+        const bool isDirectory    = entry.is_directory();
+        const int64_t size        = isDirectory ? -1 : entry.get_size();
+        const FsDirEntryType type = isDirectory ? FsDirEntryType_Dir : FsDirEntryType_File;
+
+        entryPath.assign(directoryString).append(entry.get_filename(), entry.get_filename_length());
+        metadata->records[record_key(*metadata, entryPath)] = {.exists = true, .type = type, .size = size};
+    }
+
+    metadata->records[pathString] = {.exists = true, .type = FsDirEntryType_Dir, .size = -1};
+    metadata->listed.insert(std::move(pathString));
+}
+
+void fslib::cache::clear_device(std::string_view deviceName)
+{
+    std::string prefix{deviceName};
+    prefix += ':';
+
+    {
+        std::lock_guard<std::mutex> sizeGuard{s_sizeLock};
+        std::erase_if(s_directorySizes, [&](const auto &cached) { return cached.first.starts_with(prefix); });
+    }
+
+    {
+        std::lock_guard<std::mutex> knownGuard{s_knownLock};
+        std::erase_if(s_knownDirectories, [&](const std::string &known) { return known.starts_with(prefix); });
+    }
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(deviceName);
+    if (!metadata) { return; }
+
+    metadata->records.clear();
+    metadata->listed.clear();
+}
+
+void fslib::cache::created(const fslib::PathView &path, FsDirEntryType type, int64_t size)
+{
+    const std::string key = cache::make_key(path);
+    invalidate_sizes(key);
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(path.get_device_name());
+    if (!metadata) { return; }
+
+    if (type == FsDirEntryType_Dir) { cache::add_known_directory(key); }
+
+    fslib::PathView::Buffer pathBuffer;
+    std::string pathString        = record_key(*metadata, path.get_path(pathBuffer));
+    metadata->records[pathString] = {.exists = true, .type = type, .size = size};
+
+    // A directory that was just created is known to be empty.
+    if (type == FsDirEntryType_Dir) { metadata->listed.insert(std::move(pathString)); }
+}
+
+void fslib::cache::removed(const fslib::PathView &path, bool recursive)
+{
+    const std::string key = cache::make_key(path);
+    invalidate_sizes(key);
+    forget_directories(key);
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(path.get_device_name());
+    if (!metadata) { return; }
+
+    fslib::PathView::Buffer pathBuffer;
+    const std::string pathString  = record_key(*metadata, path.get_path(pathBuffer));
+    metadata->records[pathString] = {.exists = false, .type = FsDirEntryType_File, .size = -1};
+    metadata->listed.erase(pathString);
+    if (recursive) { erase_children(*metadata, pathString); }
+}
+
+void fslib::cache::renamed(const fslib::PathView &oldPath, const fslib::PathView &newPath, FsDirEntryType type)
+{
+    const std::string oldKey = cache::make_key(oldPath);
+    invalidate_sizes(oldKey);
+    invalidate_sizes(cache::make_key(newPath));
+    if (type == FsDirEntryType_Dir) { forget_directories(oldKey); }
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(oldPath.get_device_name());
+    if (!metadata) { return; }
+
+    // A file keeps its size. A directory's contents aren't moved over, so they have to be asked for again.
+    fslib::PathView::Buffer pathBuffer;
+    const std::string oldString = record_key(*metadata, oldPath.get_path(pathBuffer));
+    const std::string newString = record_key(*metadata, newPath.get_path(pathBuffer));
+    int64_t size{-1};
+    const auto findOld = metadata->records.find(oldString);
+    if (type == FsDirEntryType_File && findOld != metadata->records.end()) { size = findOld->second.size; }
+
+    metadata->records[oldString] = {.exists = false, .type = FsDirEntryType_File, .size = -1};
+    metadata->records[newString] = {.exists = true, .type = type, .size = size};
+    metadata->listed.erase(oldString);
+    metadata->listed.erase(newString);
+    if (type == FsDirEntryType_Dir)
+    {
+        erase_children(*metadata, oldString);
+        erase_children(*metadata, newString);
+    }
+}
+
+void fslib::cache::written(std::string_view key, int64_t size)
+{
+    invalidate_sizes(key);
+
+    const size_t colon = key.find_first_of(':');
+    if (colon == key.npos) { return; }
+
+    std::lock_guard<std::mutex> metadataGuard{s_metadataLock};
+    DeviceMetadata *metadata = find_device(key.substr(0, colon));
+    if (!metadata) { return; }
+
+    const std::string pathString  = record_key(*metadata, key.substr(colon + 1));
+    metadata->records[pathString] = {.exists = true, .type = FsDirEntryType_File, .size = size};
+}
+
+static bool contains_key(std::string_view keyA, std::string_view keyB)
+{
+    if (!keyB.starts_with(keyA)) { return false; }
+
+    const size_t lengthA = keyA.length();
+    return lengthA == keyB.length() || keyA.back() == '/' || keyB[lengthA] == '/';
+}
+
+static std::string_view parent_of(std::string_view path)
+{
+    const size_t lastSlash = path.find_last_of('/');
+    if (lastSlash == path.npos || path.length() <= 1) { return {}; }
+    else if (lastSlash == 0) { return path.substr(0, 1); }
+
+    return path.substr(0, lastSlash);
+}
+
+static void invalidate_sizes(std::string_view key)
+{
+    std::lock_guard<std::mutex> sizeGuard{s_sizeLock};
+    if (s_directorySizes.empty()) { return; }
+
+    // A change to a path changes the size of every directory above it. Deleting or renaming a directory also takes
+    // everything under it with it.
+    std::erase_if(s_directorySizes, [key](const auto &cached) {
+        return contains_key(cached.first, key) || contains_key(key, cached.first);
+    });
+}
+
+static void forget_directories(std::string_view key)
+{
+    std::lock_guard<std::mutex> knownGuard{s_knownLock};
+    if (s_knownDirectories.empty()) { return; }
+
+    std::erase_if(s_knownDirectories, [key](const std::string &known) { return contains_key(key, known); });
+}
+
+static void erase_children(DeviceMetadata &metadata, std::string_view path)
+{
+    const auto isChild = [path](std::string_view cachedPath) {
+        return cachedPath.length() > path.length() && contains_key(path, cachedPath);
+    };
+
+    std::erase_if(metadata.records, [&](const auto &record) { return isChild(record.first); });
+    std::erase_if(metadata.listed, [&](const std::string &listedPath) { return isChild(listedPath); });
+}
+
+static DeviceMetadata *find_device(std::string_view deviceName)
+{
+    const auto findDevice = s_deviceMetadata.find(std::string{deviceName});
+    if (findDevice == s_deviceMetadata.end()) { return nullptr; }
+
+    return &findDevice->second;
+}
+
+static std::string record_key(const DeviceMetadata &metadata, std::string_view path)
+{
+    std::string key{path};
+    if (!metadata.ignoreCase) { return key; }
+
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char character) { return std::tolower(character); });
+    return key;
+}
@@ -2,14 +2,17 @@
 
 #include "error.hpp"
 #include "fslib.hpp"
+#include "stats_recorder.hpp"
+#include "trace_recorder.hpp"
 
 bool fslib::commit_data_to_file_system(std::string_view device)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::COMMIT}, device};
     FsFileSystem *filesystem{};
     const bool found = fslib::get_file_system_by_device_name(device, &filesystem);
     if (!found) { return false; }
 
-    const bool commitError = error::occurred(fsFsCommit(filesystem));
+    const bool commitError = error::occurred(stats::commit(stats::get_counters(device), filesystem));
     if (commitError) { return false; }
 
     return true;
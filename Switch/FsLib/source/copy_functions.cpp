@@ -0,0 +1,353 @@
+#include "copy_functions.hpp"
+
+#include "Directory.hpp"
+#include "File.hpp"
+#include "WorkerPool.hpp"
+#include "directory_functions.hpp"
+#include "error.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Anything less than this and the threads just take turns.
+    constexpr int MINIMUM_BUFFER_COUNT = 2;
+
+    // Smallest buffer used. Zero would never read anything and tiny buffers are all service call overhead.
+    constexpr size_t MINIMUM_BUFFER_SIZE = 0x1000;
+
+    // Most buffers the pool will hold onto between copies.
+    constexpr size_t MAXIMUM_POOLED_BUFFERS = 16;
+
+    // Most small files copy_directory_recursively will put in a single batch.
+    constexpr size_t MAXIMUM_BATCH_COUNT = 32;
+
+    // A buffer passed from the reading thread to the writing thread.
+    typedef struct
+    {
+            std::unique_ptr<unsigned char[]> data;
+            size_t size;
+    } CopyChunk;
+
+    // A file found while walking the source directory.
+    typedef struct
+    {
+            fslib::Path source;
+            fslib::Path destination;
+            int64_t size;
+    } CopyJob;
+
+    // Buffers kept between copies so they don't need to be allocated every time.
+    std::mutex s_poolLock{};
+    size_t s_pooledSize{};
+    std::vector<std::unique_ptr<unsigned char[]>> s_bufferPool{};
+} // namespace
+
+// Defined at bottom.
+static std::unique_ptr<unsigned char[]> acquire_buffer(size_t bufferSize);
+static void release_buffer(std::unique_ptr<unsigned char[]> buffer, size_t bufferSize);
+static bool create_tree(const fslib::Path &source, const fslib::Path &destination, std::vector<CopyJob> &jobsOut);
+static bool copy_whole_file(const CopyJob &job, unsigned char *buffer, size_t bufferSize);
+static bool copy_file_range(const fslib::File &source,
+                            fslib::File &destination,
+                            int64_t offset,
+                            int64_t length,
+                            unsigned char *buffer,
+                            size_t bufferSize);
+static void write_stats(std::chrono::steady_clock::time_point copyBegin, int64_t bytesCopied, fslib::CopyStats *statsOut);
+
+bool fslib::copy_file(const fslib::PathView &source,
+                      const fslib::PathView &destination,
+                      const fslib::CopyOptions &options,
+                      fslib::CopyStats *statsOut)
+{
+    const auto copyBegin = std::chrono::steady_clock::now();
+
+    // Both files skip the internal buffer. Everything here is already in large chunks.
+    fslib::File sourceFile{source, FsOpenMode_Read, 0, 0};
+    if (!sourceFile.is_open()) { return false; }
+
+    const int64_t sourceSize = sourceFile.get_size();
+    fslib::File destinationFile{destination, FsOpenMode_Create | FsOpenMode_Write, sourceSize, 0};
+    if (!destinationFile.is_open()) { return false; }
+
+    const size_t bufferSize = options.bufferSize < MINIMUM_BUFFER_SIZE ? MINIMUM_BUFFER_SIZE : options.bufferSize;
+    const int bufferCount   = options.bufferCount < MINIMUM_BUFFER_COUNT ? MINIMUM_BUFFER_COUNT : options.bufferCount;
+
+    std::mutex queueLock{};
+    std::condition_variable queueCondition{};
+    std::deque<CopyChunk> chunkQueue{};
+    int buffersInFlight{};
+    bool readingDone{};
+    bool copyFailed{};
+    int64_t bytesWritten{};
+
+    // The writing thread. Reading stays on this one.
+    std::thread writeThread([&]() {
+        while (true)
+        {
+            CopyChunk chunk{};
+            {
+                std::unique_lock<std::mutex> queueGuard{queueLock};
+                queueCondition.wait(queueGuard, [&]() { return !chunkQueue.empty() || readingDone || copyFailed; });
+                if (chunkQueue.empty() || copyFailed) { return; }
+
+                chunk = std::move(chunkQueue.front());
+                chunkQueue.pop_front();
+            }
+
+            const bool writeError = destinationFile.write(chunk.data.get(), chunk.size) != static_cast<ssize_t>(chunk.size);
+            release_buffer(std::move(chunk.data), bufferSize);
+
+            {
+                std::lock_guard<std::mutex> queueGuard{queueLock};
+                --buffersInFlight;
+                if (writeError) { copyFailed = true; }
+                else { bytesWritten += chunk.size; }
+            }
+            queueCondition.notify_all();
+        }
+    });
+
+    int64_t bytesRead{};
+    while (bytesRead < sourceSize)
+    {
+        {
+            std::unique_lock<std::mutex> queueGuard{queueLock};
+            queueCondition.wait(queueGuard, [&]() { return buffersInFlight < bufferCount || copyFailed; });
+            if (copyFailed) { break; }
+        }
+
+        CopyChunk chunk{acquire_buffer(bufferSize), 0};
+        const ssize_t readCount = sourceFile.read(chunk.data.get(), bufferSize);
+        if (readCount <= 0)
+        {
+            release_buffer(std::move(chunk.data), bufferSize);
+            std::lock_guard<std::mutex> queueGuard{queueLock};
+            copyFailed = true;
+            break;
+        }
+        chunk.size = readCount;
+        bytesRead += readCount;
+
+        {
+            std::lock_guard<std::mutex> queueGuard{queueLock};
+            chunkQueue.push_back(std::move(chunk));
+            ++buffersInFlight;
+        }
+        queueCondition.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> queueGuard{queueLock};
+        readingDone = true;
+    }
+    queueCondition.notify_all();
+    writeThread.join();
+
+    // Anything left behind after a failure still goes back to the pool.
+    for (CopyChunk &chunk : chunkQueue) { release_buffer(std::move(chunk.data), bufferSize); }
+    if (copyFailed) { return false; }
+
+    write_stats(copyBegin, bytesWritten, statsOut);
+    return true;
+}
+
+bool fslib::copy_directory_recursively(const fslib::PathView &source,
+                                       const fslib::PathView &destination,
+                                       const fslib::CopyOptions &options,
+                                       fslib::CopyStats *statsOut)
+{
+    const auto copyBegin = std::chrono::steady_clock::now();
+
+    // The whole skeleton is created before anything is copied so no worker has to wait on a directory.
+    std::vector<CopyJob> jobs{};
+    if (!create_tree(fslib::Path{source}, fslib::Path{destination}, jobs)) { return false; }
+
+    const size_t bufferSize = options.bufferSize < MINIMUM_BUFFER_SIZE ? MINIMUM_BUFFER_SIZE : options.bufferSize;
+    std::atomic<bool> copyFailed{};
+    std::atomic<int64_t> bytesCopied{};
+
+    // This is scoped so the pool is finished with everything before the results are checked.
+    {
+        WorkerPool pool{options.threadCount};
+
+        std::vector<const CopyJob *> batch{};
+        int64_t batchSize{};
+        const auto pushBatch = [&]() {
+            if (batch.empty()) { return; }
+
+            pool.push([&, batch]() {
+                std::unique_ptr<unsigned char[]> buffer = acquire_buffer(bufferSize);
+                for (const CopyJob *job : batch)
+                {
+                    if (!copy_whole_file(*job, buffer.get(), bufferSize)) { copyFailed = true; }
+                    else { bytesCopied += job->size; }
+                }
+                release_buffer(std::move(buffer), bufferSize);
+            });
+            batch.clear();
+            batchSize = 0;
+        };
+
+        for (const CopyJob &job : jobs)
+        {
+            if (job.size <= options.smallFileSize)
+            {
+                // Small files are all open and close. Handing them out in groups keeps the queues from filling with tiny
+                // tasks.
+                batch.push_back(&job);
+                batchSize += job.size;
+                const bool batchFull = batchSize >= static_cast<int64_t>(bufferSize) || batch.size() >= MAXIMUM_BATCH_COUNT;
+                if (batchFull) { pushBatch(); }
+                continue;
+            }
+            else if (options.splitSize <= 0 || job.size <= options.splitSize)
+            {
+                pool.push([&, jobPointer = &job]() {
+                    std::unique_ptr<unsigned char[]> buffer = acquire_buffer(bufferSize);
+                    if (!copy_whole_file(*jobPointer, buffer.get(), bufferSize)) { copyFailed = true; }
+                    else { bytesCopied += jobPointer->size; }
+                    release_buffer(std::move(buffer), bufferSize);
+                });
+                continue;
+            }
+
+            // Large files are opened once here and shared. read_at and write_at are safe to use from every worker.
+            static constexpr uint32_t CREATE_FLAGS = FsOpenMode_Create | FsOpenMode_Write;
+            auto sourceFile      = std::make_shared<fslib::File>(job.source, FsOpenMode_Read, 0, 0);
+            auto destinationFile = std::make_shared<fslib::File>(job.destination, CREATE_FLAGS, job.size, 0);
+            if (!sourceFile->is_open() || !destinationFile->is_open())
+            {
+                copyFailed = true;
+                continue;
+            }
+
+            for (int64_t offset = 0; offset < job.size; offset += options.splitSize)
+            {
+                const int64_t left   = job.size - offset;
+                const int64_t length = left < options.splitSize ? left : options.splitSize;
+                pool.push([&, sourceFile, destinationFile, offset, length]() {
+                    std::unique_ptr<unsigned char[]> buffer = acquire_buffer(bufferSize);
+                    if (!copy_file_range(*sourceFile, *destinationFile, offset, length, buffer.get(), bufferSize))
+                    {
+                        copyFailed = true;
+                    }
+                    else { bytesCopied += length; }
+                    release_buffer(std::move(buffer), bufferSize);
+                });
+            }
+        }
+        pushBatch();
+        pool.wait();
+    }
+
+    if (copyFailed) { return false; }
+
+    write_stats(copyBegin, bytesCopied, statsOut);
+    return true;
+}
+
+static std::unique_ptr<unsigned char[]> acquire_buffer(size_t bufferSize)
+{
+    {
+        std::lock_guard<std::mutex> poolGuard{s_poolLock};
+        if (s_pooledSize == bufferSize && !s_bufferPool.empty())
+        {
+            std::unique_ptr<unsigned char[]> buffer = std::move(s_bufferPool.back());
+            s_bufferPool.pop_back();
+            return buffer;
+        }
+    }
+    return std::make_unique<unsigned char[]>(bufferSize);
+}
+
+static void release_buffer(std::unique_ptr<unsigned char[]> buffer, size_t bufferSize)
+{
+    std::lock_guard<std::mutex> poolGuard{s_poolLock};
+
+    // The pool only holds one size at a time. The latest size wins.
+    if (s_pooledSize != bufferSize)
+    {
+        s_bufferPool.clear();
+        s_pooledSize = bufferSize;
+    }
+
+    if (s_bufferPool.size() < MAXIMUM_POOLED_BUFFERS) { s_bufferPool.push_back(std::move(buffer)); }
+}
+
+static bool create_tree(const fslib::Path &source, const fslib::Path &destination, std::vector<CopyJob> &jobsOut)
+{
+    // Sorting doesn't matter here.
+    fslib::Directory sourceDirectory{source, false};
+    if (!sourceDirectory.is_open()) { return false; }
+
+    const bool destinationExists = fslib::directory_exists(destination);
+    const bool destinationFailed = !destinationExists && !fslib::create_directory(destination);
+    if (destinationFailed) { return false; }
+
+    for (const fslib::DirectoryEntry &entry : sourceDirectory)
+    {
+        const fslib::Path sourcePath{source / entry};
+        const fslib::Path destinationPath{destination / entry};
+        if (entry.is_directory())
+        {
+            if (!create_tree(sourcePath, destinationPath, jobsOut)) { return false; }
+            continue;
+        }
+
+        jobsOut.push_back({sourcePath, destinationPath, entry.get_size()});
+    }
+    return true;
+}
+
+static bool copy_whole_file(const CopyJob &job, unsigned char *buffer, size_t bufferSize)
+{
+    fslib::File sourceFile{job.source, FsOpenMode_Read, 0, 0};
+    fslib::File destinationFile{job.destination, FsOpenMode_Create | FsOpenMode_Write, job.size, 0};
+    if (!sourceFile.is_open() || !destinationFile.is_open()) { return false; }
+
+    return copy_file_range(sourceFile, destinationFile, 0, job.size, buffer, bufferSize);
+}
+
+static bool copy_file_range(const fslib::File &source,
+                            fslib::File &destination,
+                            int64_t offset,
+                            int64_t length,
+                            unsigned char *buffer,
+                            size_t bufferSize)
+{
+    const int64_t end = offset + length;
+    while (offset < end)
+    {
+        const int64_t left      = end - offset;
+        const size_t readSize   = left < static_cast<int64_t>(bufferSize) ? left : bufferSize;
+        const ssize_t readCount = source.read_at(offset, buffer, readSize);
+        if (readCount <= 0) { return false; }
+
+        const bool writeError = destination.write_at(offset, buffer, readCount) != readCount;
+        if (writeError) { return false; }
+
+        offset += readCount;
+    }
+    return true;
+}
+
+static void write_stats(std::chrono::steady_clock::time_point copyBegin, int64_t bytesCopied, fslib::CopyStats *statsOut)
+{
+    if (!statsOut) { return; }
+
+    const auto copyEnd       = std::chrono::steady_clock::now();
+    const auto copyTime      = std::chrono::duration_cast<std::chrono::nanoseconds>(copyEnd - copyBegin);
+    const double seconds     = static_cast<double>(copyTime.count()) / 1000000000.0;
+    statsOut->bytesCopied    = bytesCopied;
+    statsOut->nanoseconds    = copyTime.count();
+    statsOut->bytesPerSecond = seconds > 0.0 ? static_cast<double>(bytesCopied) / seconds : 0.0;
+}
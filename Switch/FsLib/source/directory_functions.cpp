@@ -1,118 +1,203 @@
 #include "directory_functions.hpp"
 
+#include "cache.hpp"
 #include "error.hpp"
 #include "fslib.hpp"
+#include "trace_recorder.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <string_view>
 #include <switch.h>
 
 namespace
 {
     constexpr uint32_t OPEN_DIR_FLAGS = FsDirOpenMode_ReadDirs | FsDirOpenMode_ReadFiles;
-}
 
-bool fslib::create_directory(const fslib::Path &directoryPath)
+    /// @brief Result returned when nothing exists at a path.
+    constexpr Result RESULT_PATH_NOT_FOUND = MAKERESULT(Module_Fs, 1);
+
+    /// @brief Result returned when something already exists at a path.
+    constexpr Result RESULT_PATH_ALREADY_EXISTS = MAKERESULT(Module_Fs, 2);
+} // namespace
+
+/// @brief Asks the file system to delete or clean the directory on its own.
+/// @return True if it did. False if it couldn't.
+static bool native_delete(FsFileSystem *filesystem, const fslib::PathView &directoryPath, bool keepRoot);
+
+/// @brief Deletes everything under the directory one entry at a time from a post-order walk.
+/// @return True on success. False on failure.
+static bool fallback_delete(FsFileSystem *filesystem, const fslib::PathView &directoryPath, bool keepRoot, int threadCount);
+
+bool fslib::create_directory(const fslib::PathView &directoryPath)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::CREATE_DIRECTORY}, directoryPath};
     FsFileSystem *filesystem{};
     const bool isValid = directoryPath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(directoryPath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(directoryPath, &filesystem);
     if (!isValid || !found) { return false; }
 
-    const bool dirError = error::occurred(fsFsCreateDirectory(filesystem, directoryPath.get_path()));
+    fslib::PathView::Buffer pathBuffer;
+    const bool dirError = error::occurred(fsFsCreateDirectory(filesystem, directoryPath.get_path(pathBuffer)));
     if (dirError) { return false; }
 
+    cache::created(directoryPath, FsDirEntryType_Dir, -1);
     return true;
 }
 
-bool fslib::create_directories_recursively(const fslib::Path &directoryPath)
+bool fslib::create_directories_recursively(const fslib::PathView &directoryPath)
 {
-    size_t slashPosition = directoryPath.find_first_of('/');
-    if (!directoryPath.is_valid() || slashPosition == directoryPath.NOT_FOUND) { return false; }
-
-    ++slashPosition;
-    do {
-        slashPosition                      = directoryPath.find_first_of('/', slashPosition);
-        const fslib::Path currentDirectory = directoryPath.sub_path(slashPosition);
-        const bool directoryExists         = fslib::directory_exists(currentDirectory);
-        const bool createFailed            = !directoryExists && !fslib::create_directory(currentDirectory);
-        if (!directoryExists && createFailed) { return false; }
-        ++slashPosition;
-    } while (slashPosition < directoryPath.get_length());
+    FsFileSystem *filesystem{};
+    const bool isValid = directoryPath.is_valid();
+    const bool found   = isValid && fslib::get_file_system(directoryPath, &filesystem);
+    if (!isValid || !found) { return false; }
+
+    // Known directories are only trusted on devices fslib is told it has to itself. Anywhere else, every level is checked.
+    const bool useKnown = cache::metadata_enabled(directoryPath.get_device_name());
+
+    // The key for every level is a prefix of the key for the whole path.
+    const std::string key   = cache::make_key(directoryPath);
+    const size_t pathOffset = key.length() - directoryPath.get_length();
+    if (useKnown && cache::directory_known(key)) { return true; }
+
+    // Work backwards from the deepest level until something that exists is found. 0 is the root.
+    const std::string_view path = directoryPath.get_path();
+    size_t existingLength       = path.length();
+    fslib::PathView::Buffer pathBuffer;
+    while (existingLength > 0)
+    {
+        const std::string_view levelKey = std::string_view{key}.substr(0, pathOffset + existingLength);
+        if (useKnown && cache::directory_known(levelKey)) { break; }
+
+        const fslib::PathView levelPath = directoryPath.sub_path(existingLength);
+        FsDirEntryType entryType{};
+        const Result typeResult = fsFsGetEntryType(filesystem, levelPath.get_path(pathBuffer), &entryType);
+
+        const bool notFound   = R_FAILED(typeResult) && R_VALUE(typeResult) == RESULT_PATH_NOT_FOUND;
+        const bool typeError  = R_FAILED(typeResult) && !notFound;
+        const bool isFile     = R_SUCCEEDED(typeResult) && entryType != FsDirEntryType_Dir;
+        const bool levelError = typeError ? error::occurred(typeResult) : isFile && error::occurred(RESULT_PATH_ALREADY_EXISTS);
+        if (levelError) { return false; }
+        else if (!notFound)
+        {
+            if (useKnown) { cache::add_known_directory(levelKey); }
+            break;
+        }
+
+        // Paths without a slash after the device run out of slashes before reaching the root.
+        const size_t levelStart = path.find_last_of('/', existingLength - 1);
+        existingLength          = levelStart == path.npos ? 0 : levelStart;
+    }
+
+    // Only what's missing after that gets created.
+    while (existingLength < path.length())
+    {
+        const size_t levelEnd = std::min(path.find_first_of('/', existingLength + 1), path.length());
+        if (!fslib::create_directory(directoryPath.sub_path(levelEnd)))
+        {
+            // Something outside of fslib might have deleted a directory that was known to exist.
+            cache::clear_known_directories();
+            return false;
+        }
+        existingLength = levelEnd;
+    }
+
     return true;
 }
 
-bool fslib::delete_directory(const fslib::Path &directoryPath)
+bool fslib::delete_directory(const fslib::PathView &directoryPath)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::DELETE_DIRECTORY}, directoryPath};
     FsFileSystem *filesystem{};
     const bool isValid = directoryPath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(directoryPath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(directoryPath, &filesystem);
     if (!isValid || !found) { return false; }
 
-    const bool deleteError = error::occurred(fsFsDeleteDirectory(filesystem, directoryPath.get_path()));
+    fslib::PathView::Buffer pathBuffer;
+    const bool deleteError = error::occurred(fsFsDeleteDirectory(filesystem, directoryPath.get_path(pathBuffer)));
     if (deleteError) { return false; }
+
+    cache::removed(directoryPath, false);
     return true;
 }
 
-bool fslib::delete_directory_recursively(const fslib::Path &directoryPath)
+bool fslib::delete_directory_recursively(const fslib::PathView &directoryPath, const fslib::DeleteOptions &options)
 {
-    fslib::Directory targetDirectory{directoryPath};
-    if (!targetDirectory.is_open()) { return false; }
-
-    for (const fslib::DirectoryEntry &entry : targetDirectory)
-    {
-        const fslib::Path targetPath{directoryPath / entry};
-        const bool isDirectory = entry.is_directory();
-        const bool dirDeleted  = isDirectory && fslib::delete_directory_recursively(targetPath);
-        const bool fileDeleted = !isDirectory && fslib::delete_file(targetPath);
-        if (!dirDeleted && !fileDeleted) { return false; }
-    }
+    trace::Scope traceScope{{.operation = trace::Operation::DELETE_DIRECTORY_RECURSIVELY,
+                             .size      = options.threadCount,
+                             .option    = options.keepRoot},
+                            directoryPath};
+    FsFileSystem *filesystem{};
+    const bool isValid = directoryPath.is_valid();
+    const bool found   = isValid && fslib::get_file_system(directoryPath, &filesystem);
+    if (!isValid || !found) { return false; }
 
     // This is to prevent failure from trying to delete the root.
-    const size_t pathLength  = std::char_traits<char>::length(directoryPath.get_path());
-    const bool attemptDelete = pathLength > 1;
-    const bool deleteFailed  = attemptDelete && !fslib::delete_directory(directoryPath);
-    if (attemptDelete && deleteFailed) { return false; }
+    const bool keepRoot = options.keepRoot || directoryPath.get_path() == "/";
 
-    return true;
+    const bool deleted = native_delete(filesystem, directoryPath, keepRoot) ||
+                         fallback_delete(filesystem, directoryPath, keepRoot, options.threadCount);
+
+    // Whatever got deleted before a failure is gone either way.
+    cache::removed(directoryPath, true);
+    if (keepRoot) { cache::created(directoryPath, FsDirEntryType_Dir, -1); }
+
+    return deleted;
 }
 
-bool fslib::directory_exists(const fslib::Path &directoryPath)
+bool fslib::directory_exists(const fslib::PathView &directoryPath)
 {
     FsFileSystem *filesystem{};
     const bool isValid = directoryPath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(directoryPath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(directoryPath, &filesystem);
     if (!isValid || !found) { return false; }
 
+    cache::Metadata metadata{};
+    const bool known =
+        cache::metadata_enabled(directoryPath.get_device_name()) && cache::query_metadata(filesystem, directoryPath, metadata);
+    if (known) { return metadata.exists && metadata.type == FsDirEntryType_Dir; }
+
+    fslib::PathView::Buffer pathBuffer;
     FsDir handle{};
-    const bool dirError = error::occurred(fsFsOpenDirectory(filesystem, directoryPath.get_path(), OPEN_DIR_FLAGS, &handle));
+    const char *path    = directoryPath.get_path(pathBuffer);
+    const bool dirError = error::occurred(fsFsOpenDirectory(filesystem, path, OPEN_DIR_FLAGS, &handle));
     if (dirError) { return false; }
 
     fsDirClose(&handle);
     return true;
 }
 
-bool fslib::rename_directory(const fslib::Path &oldPath, const fslib::Path &newPath)
+bool fslib::rename_directory(const fslib::PathView &oldPath, const fslib::PathView &newPath)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::RENAME_DIRECTORY}, oldPath, newPath};
     FsFileSystem *filesystem{};
     const bool pathsValid = oldPath.is_valid() && newPath.is_valid();
     const bool sameDevice = pathsValid && oldPath.get_device_name() == newPath.get_device_name();
-    const bool found      = sameDevice && fslib::get_file_system_by_device_name(oldPath.get_device_name(), &filesystem);
+    const bool found      = sameDevice && fslib::get_file_system(oldPath, &filesystem);
     if (!pathsValid || !sameDevice || !found) { return false; }
 
-    const bool renameError = error::occurred(fsFsRenameDirectory(filesystem, oldPath.get_path(), newPath.get_path()));
+    fslib::PathView::Buffer oldBuffer;
+    fslib::PathView::Buffer newBuffer;
+    const char *oldFsPath  = oldPath.get_path(oldBuffer);
+    const char *newFsPath  = newPath.get_path(newBuffer);
+    const bool renameError = error::occurred(fsFsRenameDirectory(filesystem, oldFsPath, newFsPath));
     if (renameError) { return false; }
+
+    cache::renamed(oldPath, newPath, FsDirEntryType_Dir);
     return true;
 }
 
-bool fslib::get_directory_entry_count(const fslib::Path &directoryPath, int64_t &countOut)
+bool fslib::get_directory_entry_count(const fslib::PathView &directoryPath, int64_t &countOut)
 {
     FsFileSystem *filesystem{};
     const bool pathValid = directoryPath.is_valid();
-    const bool found     = fslib::get_file_system_by_device_name(directoryPath.get_device_name(), &filesystem);
+    const bool found     = fslib::get_file_system(directoryPath, &filesystem);
     if (!pathValid || !found) { return false; }
 
+    fslib::PathView::Buffer pathBuffer;
     FsDir handle{};
-    const bool openError  = error::occurred(fsFsOpenDirectory(filesystem, directoryPath.get_path(), OPEN_DIR_FLAGS, &handle));
+    const char *path      = directoryPath.get_path(pathBuffer);
+    const bool openError  = error::occurred(fsFsOpenDirectory(filesystem, path, OPEN_DIR_FLAGS, &handle));
     const bool countError = !openError && error::occurred(fsDirGetEntryCount(&handle, &countOut));
     if (openError || countError)
     {
@@ -122,4 +207,71 @@ bool fslib::get_directory_entry_count(const fslib::Path &directoryPath, int64_t
 
     fsDirClose(&handle);
     return true;
-}
\ No newline at end of file
+}
+
+int64_t fslib::get_directory_size(const fslib::PathView &directoryPath, const fslib::DirectorySizeOptions &options)
+{
+    int64_t directorySize{};
+    const bool cached = options.useCache && cache::get_directory_size(directoryPath, directorySize);
+    if (cached) { return directorySize; }
+
+    std::atomic<int64_t> totalSize{};
+    const fslib::WalkOptions walkOptions{.threadCount = options.threadCount, .postOrder = false};
+    const bool walked = fslib::walk(
+        directoryPath,
+        [&](const fslib::Path &, const FsDirectoryEntry &entry, int) {
+            if (entry.type == FsDirEntryType_File) { totalSize.fetch_add(entry.file_size, std::memory_order_relaxed); }
+            return fslib::WalkAction::CONTINUE;
+        },
+        walkOptions);
+
+    // The total is short if anything couldn't be read. It can't be returned and, worse, cached for later calls.
+    if (!walked) { return -1; }
+
+    directorySize = totalSize;
+    if (options.useCache) { cache::set_directory_size(directoryPath, directorySize); }
+
+    return directorySize;
+}
+
+void fslib::clear_directory_size_cache() { cache::clear_directory_sizes(); }
+
+static bool native_delete(FsFileSystem *filesystem, const fslib::PathView &directoryPath, bool keepRoot)
+{
+    fslib::PathView::Buffer pathBuffer;
+    const char *path          = directoryPath.get_path(pathBuffer);
+    const Result deleteResult = keepRoot ? fsFsCleanDirectoryRecursively(filesystem, path)
+                                         : fsFsDeleteDirectoryRecursively(filesystem, path);
+    if (R_SUCCEEDED(deleteResult)) { return true; }
+
+    // Not finding the directory is a real failure. Anything else is left for the fallback to try.
+    if (R_VALUE(deleteResult) == RESULT_PATH_NOT_FOUND) { fslib::error::occurred(deleteResult); }
+    return false;
+}
+
+static bool fallback_delete(FsFileSystem *filesystem, const fslib::PathView &directoryPath, bool keepRoot, int threadCount)
+{
+    if (!fslib::directory_exists(directoryPath)) { return false; }
+
+    // Entries are streamed in batches instead of every level being read up front. Files are deleted as they're read and
+    // directories once everything in them is gone.
+    std::atomic<bool> deleteFailed{false};
+    const fslib::WalkOptions walkOptions{.threadCount = threadCount, .postOrder = true};
+    const bool walked = fslib::walk(
+        directoryPath,
+        [&](const fslib::Path &entryPath, const FsDirectoryEntry &entry, int) {
+            const char *path          = entryPath.get_path();
+            const bool isDirectory    = entry.type == FsDirEntryType_Dir;
+            const Result deleteResult = isDirectory ? fsFsDeleteDirectory(filesystem, path) : fsFsDeleteFile(filesystem, path);
+            if (!fslib::error::occurred(deleteResult)) { return fslib::WalkAction::CONTINUE; }
+
+            deleteFailed = true;
+            return fslib::WalkAction::STOP;
+        },
+        walkOptions);
+    if (!walked || deleteFailed) { return false; }
+    else if (keepRoot) { return true; }
+
+    fslib::PathView::Buffer pathBuffer;
+    return !fslib::error::occurred(fsFsDeleteDirectory(filesystem, directoryPath.get_path(pathBuffer)));
+}
@@ -1,21 +1,37 @@
 #include "error.hpp"
 
-#include <cstdarg>
+#include <cstdio>
 
 namespace
 {
-    // Buffer size for va_list strings.
-    constexpr int VA_BUFFER_SIZE = 0x1000;
+    // Buffer size for the formatted string. Anything past this is cut off.
+    constexpr int ERROR_BUFFER_SIZE = 0x200;
 
-    /// @brief This is the internal error string.
-    constinit char s_errorBuffer[VA_BUFFER_SIZE] = {0};
-} // namespace
+    /// @brief The last error recorded by a thread. The string is only built from this when it's asked for.
+    struct ErrorState
+    {
+            /// @brief Code that was recorded.
+            Result code{};
 
-const char *fslib::error::get_string() { return s_errorBuffer; }
+            /// @brief Where the code was recorded.
+            std::source_location location{};
 
-bool fslib::error::occurred(Result code, const std::source_location &location)
+            /// @brief Whether or not buffer is up to date with the code and location.
+            bool formatted = true;
+
+            /// @brief This is the error string.
+            char buffer[ERROR_BUFFER_SIZE]{};
+    };
+
+    /// @brief Each thread gets its own, so they can't overwrite each other's errors.
+    constinit thread_local ErrorState s_errorState{};
+} // namespace
+
+const char *fslib::error::get_string()
 {
-    if (code == 0) { return false; }
+    if (s_errorState.formatted) { return s_errorState.buffer; }
+
+    const std::source_location &location = s_errorState.location;
 
     // I just want the source file. Not the whole path.
     std::string_view filename = location.file_name();
@@ -27,13 +43,28 @@ bool fslib::error::occurred(Result code, const std::source_location &location)
     size_t functionBegin          = functionName.find_first_of(' ');
     if (functionBegin != functionName.npos) { functionName = functionName.substr(functionBegin + 1); }
 
-    std::snprintf(s_errorBuffer,
-                  VA_BUFFER_SIZE,
+    std::snprintf(s_errorState.buffer,
+                  ERROR_BUFFER_SIZE,
                   "fslib::%s::%s::%i:%X",
                   filename.data(),
                   functionName.data(),
                   location.line(),
-                  code);
+                  s_errorState.code);
+    s_errorState.formatted = true;
+
+    return s_errorState.buffer;
+}
+
+Result fslib::error::get_code() { return s_errorState.code; }
+
+bool fslib::error::occurred(Result code, const std::source_location &location)
+{
+    if (code == 0) { return false; }
+
+    // Failures are expected for things like checking if a file exists, so this is all that's done until the string is needed.
+    s_errorState.code      = code;
+    s_errorState.location  = location;
+    s_errorState.formatted = false;
 
     return true;
 }
@@ -1,88 +1,120 @@
 #include "file_functions.hpp"
 
+#include "cache.hpp"
 #include "error.hpp"
 #include "fslib.hpp"
+#include "trace_recorder.hpp"
 
 #include <switch.h>
 
-bool fslib::create_file(const fslib::Path &filePath, int64_t fileSize)
+bool fslib::create_file(const fslib::PathView &filePath, int64_t fileSize)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::CREATE_FILE, .size = fileSize}, filePath};
     FsFileSystem *filesystem{};
     const bool isValid = filePath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(filePath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(filePath, &filesystem);
     if (!isValid || !found) { return false; }
 
-    const bool createError = error::occurred(fsFsCreateFile(filesystem, filePath.get_path(), fileSize, 0));
+    fslib::PathView::Buffer pathBuffer;
+    const bool createError = error::occurred(fsFsCreateFile(filesystem, filePath.get_path(pathBuffer), fileSize, 0));
     if (createError) { return false; }
+
+    cache::created(filePath, FsDirEntryType_File, fileSize);
     return true;
 }
 
-bool fslib::file_exists(const fslib::Path &filePath)
+bool fslib::file_exists(const fslib::PathView &filePath)
 {
     FsFileSystem *filesystem{};
     const bool isValid = filePath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(filePath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(filePath, &filesystem);
     if (!isValid || !found) { return false; }
 
+    cache::Metadata metadata{};
+    const bool known = cache::metadata_enabled(filePath.get_device_name()) && cache::query_metadata(filesystem, filePath, metadata);
+    if (known) { return metadata.exists && metadata.type == FsDirEntryType_File; }
+
+    fslib::PathView::Buffer pathBuffer;
     FsFile handle{};
-    const bool openError = error::occurred(fsFsOpenFile(filesystem, filePath.get_path(), FsOpenMode_Read, &handle));
+    const bool openError = error::occurred(fsFsOpenFile(filesystem, filePath.get_path(pathBuffer), FsOpenMode_Read, &handle));
     if (openError) { return false; }
 
     fsFileClose(&handle);
     return true;
 }
 
-bool fslib::delete_file(const fslib::Path &filePath)
+bool fslib::delete_file(const fslib::PathView &filePath)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::DELETE_FILE}, filePath};
     FsFileSystem *filesystem{};
     const bool isValid = filePath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(filePath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(filePath, &filesystem);
     if (!isValid || !found) { return false; }
 
-    const bool deleteError = error::occurred(fsFsDeleteFile(filesystem, filePath.get_path()));
+    fslib::PathView::Buffer pathBuffer;
+    const bool deleteError = error::occurred(fsFsDeleteFile(filesystem, filePath.get_path(pathBuffer)));
     if (deleteError) { return false; }
+
+    cache::removed(filePath, false);
     return true;
 }
 
-int64_t fslib::get_file_size(const fslib::Path &filePath)
+int64_t fslib::get_file_size(const fslib::PathView &filePath)
 {
     FsFileSystem *filesystem{};
     const bool isValid = filePath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(filePath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(filePath, &filesystem);
     if (!isValid || !found) { return -1; }
 
+    cache::Metadata metadata{};
+    const bool cacheEnabled = cache::metadata_enabled(filePath.get_device_name());
+    const bool known        = cacheEnabled && cache::get_metadata(filePath, metadata);
+    if (known && (!metadata.exists || metadata.type != FsDirEntryType_File)) { return -1; }
+    else if (known && metadata.size >= 0) { return metadata.size; }
+
+    fslib::PathView::Buffer pathBuffer;
     int64_t size{};
     FsFile handle{};
-    const bool openError = error::occurred(fsFsOpenFile(filesystem, filePath.get_path(), FsOpenMode_Read, &handle));
+    const bool openError = error::occurred(fsFsOpenFile(filesystem, filePath.get_path(pathBuffer), FsOpenMode_Read, &handle));
     const bool sizeError = !openError && error::occurred(fsFileGetSize(&handle, &size));
     if (openError || sizeError) { return -1; }
 
     fsFileClose(&handle);
+    if (cacheEnabled) { cache::set_metadata(filePath, {.exists = true, .type = FsDirEntryType_File, .size = size}); }
+
     return size;
 }
 
-bool fslib::rename_file(const fslib::Path &oldPath, const fslib::Path &newPath)
+bool fslib::rename_file(const fslib::PathView &oldPath, const fslib::PathView &newPath)
 {
+    trace::Scope traceScope{{.operation = trace::Operation::RENAME_FILE}, oldPath, newPath};
     FsFileSystem *filesystem{};
     const bool validPaths  = oldPath.is_valid() && newPath.is_valid();
     const bool deviceMatch = validPaths && oldPath.get_device_name() == newPath.get_device_name();
-    const bool found       = deviceMatch && fslib::get_file_system_by_device_name(oldPath.get_device_name(), &filesystem);
+    const bool found       = deviceMatch && fslib::get_file_system(oldPath, &filesystem);
     if (!validPaths || !deviceMatch || !found) { return false; }
 
-    const bool renameError = error::occurred(fsFsRenameFile(filesystem, oldPath.get_path(), newPath.get_path()));
+    fslib::PathView::Buffer oldBuffer;
+    fslib::PathView::Buffer newBuffer;
+    const char *oldFsPath  = oldPath.get_path(oldBuffer);
+    const char *newFsPath  = newPath.get_path(newBuffer);
+    const bool renameError = error::occurred(fsFsRenameFile(filesystem, oldFsPath, newFsPath));
     if (renameError) { return false; }
+
+    cache::renamed(oldPath, newPath, FsDirEntryType_File);
     return true;
 }
 
-bool fslib::get_file_timestamp(const fslib::Path &filePath, FsTimeStampRaw &stampOut)
+bool fslib::get_file_timestamp(const fslib::PathView &filePath, FsTimeStampRaw &stampOut)
 {
     FsFileSystem *filesystem{};
     const bool isValid = filePath.is_valid();
-    const bool found   = isValid && fslib::get_file_system_by_device_name(filePath.get_device_name(), &filesystem);
+    const bool found   = isValid && fslib::get_file_system(filePath, &filesystem);
     if (!isValid || !found) { return false; }
 
-    const bool stampError = error::occurred(fsFsGetFileTimeStampRaw(filesystem, filePath.get_path(), &stampOut));
+    fslib::PathView::Buffer pathBuffer;
+    const bool stampError = error::occurred(fsFsGetFileTimeStampRaw(filesystem, filePath.get_path(pathBuffer), &stampOut));
     if (stampError) { return false; }
 
     return true;
-}
\ No newline at end of file
+}
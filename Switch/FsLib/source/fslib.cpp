@@ -1,26 +1,60 @@
 #include "fslib.hpp"
 
 #include "FsLibCore.hpp"
+#include "cache.hpp"
 #include "dev.hpp"
 #include "error.hpp"
 
 #include <unordered_map>
 
-namespace
-{
-    FsLibCore s_core{};
-}
+/// @brief Returns the core. This is created the first time it's needed instead of with the other statics, since paths
+/// declared statically need it to resolve their device.
+static FsLibCore &get_core();
 
-bool fslib::is_initialized() { return s_core.is_initialized(); }
+bool fslib::is_initialized() { return get_core().is_initialized(); }
 
 bool fslib::map_file_system(std::string_view deviceName, FsFileSystem &filesystem)
 {
-    return s_core.map_file_system(deviceName, filesystem);
+    // Whatever was cached belonged to the file system that was mapped here before.
+    cache::clear_device(deviceName);
+    return get_core().map_file_system(deviceName, filesystem);
 }
 
 bool fslib::get_file_system_by_device_name(std::string_view deviceName, FsFileSystem **filesystemOut)
 {
-    return s_core.get_file_system_by_device_name(deviceName, filesystemOut);
+    return get_core().get_file_system_by_device_name(deviceName, filesystemOut);
+}
+
+bool fslib::get_file_system(const fslib::PathView &path, FsFileSystem **filesystemOut)
+{
+    const fslib::DeviceToken &token = path.get_device_token();
+    if (token.is_current())
+    {
+        *filesystemOut = token.filesystem;
+        return true;
+    }
+
+    return get_core().get_file_system_by_device_name(path.get_device_name(), filesystemOut);
+}
+
+bool fslib::resolve_device(std::string_view deviceName, fslib::DeviceToken &tokenOut)
+{
+    return get_core().resolve_device(deviceName, tokenOut);
 }
 
-bool fslib::close_file_system(std::string_view deviceName) { return s_core.close_file_system(deviceName); }
+bool fslib::close_file_system(std::string_view deviceName)
+{
+    cache::clear_device(deviceName);
+    return get_core().close_file_system(deviceName);
+}
+
+void fslib::enable_metadata_cache(std::string_view deviceName, bool enable, bool ignoreCase)
+{
+    cache::set_metadata_enabled(deviceName, enable, ignoreCase);
+}
+
+static FsLibCore &get_core()
+{
+    static FsLibCore core{};
+    return core;
+}
@@ -0,0 +1,205 @@
+#include "stats.hpp"
+
+#include "File.hpp"
+#include "stats_recorder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#ifdef FSLIB_ENABLE_STATS
+/// @brief Live counters for a device. Everything is relaxed since these are only ever read for a snapshot.
+struct fslib::stats::Counters
+{
+        struct OperationCounters
+        {
+                std::atomic<uint64_t> calls{};
+                std::atomic<uint64_t> totalNanoseconds{};
+                std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> histogram{};
+        };
+
+        std::atomic<uint64_t> serviceCalls{};
+        std::atomic<uint64_t> bytesRead{};
+        std::atomic<uint64_t> bytesWritten{};
+        std::array<OperationCounters, OPERATION_COUNT> operations{};
+};
+
+namespace
+{
+    /// @brief Guards the map below. Counters themselves are atomic and updated without it.
+    std::mutex s_statsLock{};
+
+    /// @brief Counters for every device that's been used. These are never erased, so pointers to them stay valid.
+    std::map<std::string, std::unique_ptr<fslib::stats::Counters>, std::less<>> s_deviceCounters{};
+} // namespace
+#endif
+
+namespace
+{
+    /// @brief Names printed for each operation.
+    constexpr std::array<const char *, fslib::stats::OPERATION_COUNT> OPERATION_NAMES =
+        {"open", "read", "write", "set_size", "dir_read", "commit"};
+} // namespace
+
+bool fslib::stats::is_enabled() noexcept
+{
+#ifdef FSLIB_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *fslib::stats::get_operation_name(fslib::stats::Operation operation) noexcept
+{
+    return OPERATION_NAMES[static_cast<size_t>(operation)];
+}
+
+std::vector<fslib::stats::DeviceStats> fslib::stats::get_snapshot()
+{
+    std::vector<fslib::stats::DeviceStats> snapshot{};
+
+#ifdef FSLIB_ENABLE_STATS
+    std::lock_guard<std::mutex> statsGuard{s_statsLock};
+    snapshot.reserve(s_deviceCounters.size());
+    for (const auto &[deviceName, counters] : s_deviceCounters)
+    {
+        fslib::stats::DeviceStats &deviceStats = snapshot.emplace_back();
+        deviceStats.deviceName                 = deviceName;
+        deviceStats.serviceCalls               = counters->serviceCalls.load(std::memory_order_relaxed);
+        deviceStats.bytesRead                  = counters->bytesRead.load(std::memory_order_relaxed);
+        deviceStats.bytesWritten               = counters->bytesWritten.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < OPERATION_COUNT; i++)
+        {
+            const auto &operationCounters           = counters->operations[i];
+            fslib::stats::OperationStats &operation = deviceStats.operations[i];
+            operation.calls                         = operationCounters.calls.load(std::memory_order_relaxed);
+            operation.totalNanoseconds              = operationCounters.totalNanoseconds.load(std::memory_order_relaxed);
+            for (size_t j = 0; j < HISTOGRAM_BUCKETS; j++)
+            {
+                operation.histogram[j] = operationCounters.histogram[j].load(std::memory_order_relaxed);
+            }
+        }
+    }
+#endif
+
+    return snapshot;
+}
+
+void fslib::stats::reset()
+{
+#ifdef FSLIB_ENABLE_STATS
+    std::lock_guard<std::mutex> statsGuard{s_statsLock};
+    for (auto &[deviceName, counters] : s_deviceCounters)
+    {
+        counters->serviceCalls.store(0, std::memory_order_relaxed);
+        counters->bytesRead.store(0, std::memory_order_relaxed);
+        counters->bytesWritten.store(0, std::memory_order_relaxed);
+        for (auto &operationCounters : counters->operations)
+        {
+            operationCounters.calls.store(0, std::memory_order_relaxed);
+            operationCounters.totalNanoseconds.store(0, std::memory_order_relaxed);
+            for (auto &bucket : operationCounters.histogram) { bucket.store(0, std::memory_order_relaxed); }
+        }
+    }
+#endif
+}
+
+bool fslib::stats::dump_to_file(const fslib::PathView &filePath)
+{
+    if (!stats::is_enabled()) { return false; }
+
+    // The snapshot is taken first so the dump's own writes aren't in it.
+    const std::vector<fslib::stats::DeviceStats> snapshot = stats::get_snapshot();
+
+    fslib::File dumpFile{filePath, FsOpenMode_Create | FsOpenMode_Write};
+    if (!dumpFile.is_open()) { return false; }
+
+    for (const fslib::stats::DeviceStats &deviceStats : snapshot)
+    {
+        uint64_t deviceNanoseconds{};
+        for (const fslib::stats::OperationStats &operation : deviceStats.operations)
+        {
+            deviceNanoseconds += operation.totalNanoseconds;
+        }
+
+        dumpFile.writef("%s: %llu service calls, %llu bytes read, %llu bytes written, %.3f ms\n",
+                        deviceStats.deviceName.c_str(),
+                        static_cast<unsigned long long>(deviceStats.serviceCalls),
+                        static_cast<unsigned long long>(deviceStats.bytesRead),
+                        static_cast<unsigned long long>(deviceStats.bytesWritten),
+                        static_cast<double>(deviceNanoseconds) / 1000000.0);
+
+        for (size_t i = 0; i < OPERATION_COUNT; i++)
+        {
+            const fslib::stats::OperationStats &operation = deviceStats.operations[i];
+            if (operation.calls == 0) { continue; }
+
+            const double totalMilliseconds = static_cast<double>(operation.totalNanoseconds) / 1000000.0;
+            const double share = deviceNanoseconds > 0 ? 100.0 * operation.totalNanoseconds / deviceNanoseconds : 0.0;
+            const double averageMicroseconds = static_cast<double>(operation.totalNanoseconds) / operation.calls / 1000.0;
+            dumpFile.writef("    %-8s %llu calls, %.3f ms (%.1f%%), %.1f us avg\n",
+                            OPERATION_NAMES[i],
+                            static_cast<unsigned long long>(operation.calls),
+                            totalMilliseconds,
+                            share,
+                            averageMicroseconds);
+
+            // Only buckets that were hit are printed. The bound is the bucket's upper limit in microseconds.
+            dumpFile.writef("       ");
+            for (size_t j = 0; j < HISTOGRAM_BUCKETS; j++)
+            {
+                if (operation.histogram[j] == 0) { continue; }
+
+                const bool lastBucket = j == HISTOGRAM_BUCKETS - 1;
+                dumpFile.writef(" %s%llu:%llu",
+                                lastBucket ? ">=" : "<",
+                                1ULL << (lastBucket ? j - 1 : j),
+                                static_cast<unsigned long long>(operation.histogram[j]));
+            }
+            dumpFile.writef("\n");
+        }
+    }
+
+    return dumpFile.flush();
+}
+
+#ifdef FSLIB_ENABLE_STATS
+fslib::stats::Counters *fslib::stats::get_counters(std::string_view deviceName)
+{
+    std::lock_guard<std::mutex> statsGuard{s_statsLock};
+    auto findCounters = s_deviceCounters.find(deviceName);
+    if (findCounters == s_deviceCounters.end())
+    {
+        findCounters =
+            s_deviceCounters.try_emplace(std::string{deviceName}, std::make_unique<fslib::stats::Counters>()).first;
+    }
+
+    return findCounters->second.get();
+}
+
+void fslib::stats::record(fslib::stats::Counters *counters,
+                          fslib::stats::Operation operation,
+                          uint64_t startTick,
+                          uint64_t bytesRead,
+                          uint64_t bytesWritten) noexcept
+{
+    if (!counters) { return; }
+
+    const uint64_t nanoseconds = armTicksToNs(armGetSystemTick() - startTick);
+    const size_t bucket        = std::min<size_t>(std::bit_width(nanoseconds / 1000), HISTOGRAM_BUCKETS - 1);
+    auto &operationCounters    = counters->operations[static_cast<size_t>(operation)];
+
+    counters->serviceCalls.fetch_add(1, std::memory_order_relaxed);
+    if (bytesRead > 0) { counters->bytesRead.fetch_add(bytesRead, std::memory_order_relaxed); }
+    if (bytesWritten > 0) { counters->bytesWritten.fetch_add(bytesWritten, std::memory_order_relaxed); }
+
+    operationCounters.calls.fetch_add(1, std::memory_order_relaxed);
+    operationCounters.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    operationCounters.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+#endif
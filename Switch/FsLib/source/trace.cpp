@@ -0,0 +1,273 @@
+#include "trace.hpp"
+
+#include "error.hpp"
+#include "fslib.hpp"
+#include "trace_recorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef FSLIB_ENABLE_TRACE
+namespace
+{
+    /// @brief Size of the buffer records are collected in before being written out.
+    constexpr size_t TRACE_BUFFER_SIZE = 0x10000;
+
+    /// @brief Whether or not a trace is being recorded. Checked without the lock so idle scopes stay cheap.
+    std::atomic<bool> s_active{};
+
+    /// @brief Number of scopes open on the calling thread. Only the outermost one records.
+    thread_local uint32_t s_depth{};
+
+    /// @brief Guards everything below.
+    std::mutex s_traceLock{};
+
+    /// @brief File the trace is written to. This is written to with libnx directly so the trace doesn't trace itself.
+    FsFile s_traceFile{};
+
+    /// @brief Offset the next write to the trace file goes to.
+    int64_t s_traceOffset{};
+
+    /// @brief Tick tracing began at. Timestamps are relative to this.
+    uint64_t s_startTick{};
+
+    /// @brief Records waiting to be written out.
+    std::unique_ptr<char[]> s_traceBuffer{};
+    size_t s_bufferOffset{};
+
+    /// @brief Numbers given to open Files and DirectoryReaders. Addresses get reused, so these are erased on close.
+    std::unordered_map<const void *, uint32_t> s_handles{};
+    uint32_t s_nextHandle{};
+} // namespace
+
+// Defined at bottom.
+static bool flush_trace_buffer();
+static uint32_t get_handle(fslib::trace::Operation operation, const void *handle);
+static void write_record(const fslib::trace::Event &event, uint64_t startTick, uint64_t endTick, std::string_view path);
+#endif
+
+namespace
+{
+    /// @brief Names printed for each operation.
+    constexpr std::array<const char *, fslib::trace::OPERATION_COUNT> OPERATION_NAMES = {"open_file",
+                                                                                        "close_file",
+                                                                                        "read",
+                                                                                        "get_byte",
+                                                                                        "write",
+                                                                                        "put_byte",
+                                                                                        "read_at",
+                                                                                        "write_at",
+                                                                                        "seek",
+                                                                                        "flush",
+                                                                                        "open_dir",
+                                                                                        "read_dir",
+                                                                                        "close_dir",
+                                                                                        "create_file",
+                                                                                        "delete_file",
+                                                                                        "rename_file",
+                                                                                        "create_dir",
+                                                                                        "delete_dir",
+                                                                                        "delete_dir_r",
+                                                                                        "rename_dir",
+                                                                                        "commit"};
+} // namespace
+
+const char *fslib::trace::get_operation_name(fslib::trace::Operation operation) noexcept
+{
+    return OPERATION_NAMES[static_cast<size_t>(operation)];
+}
+
+bool fslib::trace::begin(const fslib::PathView &tracePath)
+{
+#ifdef FSLIB_ENABLE_TRACE
+    std::lock_guard<std::mutex> traceGuard{s_traceLock};
+    if (s_active.load(std::memory_order_relaxed)) { return false; }
+
+    FsFileSystem *filesystem{};
+    const bool found = fslib::get_file_system(tracePath, &filesystem);
+    if (!found) { return false; }
+
+    fslib::PathView::Buffer pathBuffer{};
+    const char *path = tracePath.get_path(pathBuffer);
+
+    // Delete can fail if the file doesn't exist. That's fine.
+    fsFsDeleteFile(filesystem, path);
+    const bool createError = error::occurred(fsFsCreateFile(filesystem, path, 0, 0));
+    const bool openError =
+        !createError && error::occurred(fsFsOpenFile(filesystem, path, FsOpenMode_Write | FsOpenMode_Append, &s_traceFile));
+    if (createError || openError) { return false; }
+
+    if (!s_traceBuffer) { s_traceBuffer = std::make_unique<char[]>(TRACE_BUFFER_SIZE); }
+
+    const fslib::trace::Header header = {.magic = MAGIC, .version = VERSION};
+    std::memcpy(s_traceBuffer.get(), &header, sizeof(fslib::trace::Header));
+    s_bufferOffset = sizeof(fslib::trace::Header);
+    s_traceOffset  = 0;
+    s_nextHandle   = 1;
+    s_handles.clear();
+
+    s_startTick = armGetSystemTick();
+    s_active.store(true, std::memory_order_release);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void fslib::trace::end()
+{
+#ifdef FSLIB_ENABLE_TRACE
+    std::lock_guard<std::mutex> traceGuard{s_traceLock};
+    if (!s_active.load(std::memory_order_relaxed)) { return; }
+
+    s_active.store(false, std::memory_order_relaxed);
+    flush_trace_buffer();
+    fsFileFlush(&s_traceFile);
+    fsFileClose(&s_traceFile);
+    s_handles.clear();
+#endif
+}
+
+bool fslib::trace::is_active() noexcept
+{
+#ifdef FSLIB_ENABLE_TRACE
+    return s_active.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+#ifdef FSLIB_ENABLE_TRACE
+fslib::trace::Scope::Scope(const fslib::trace::Event &event) noexcept
+    : m_event(event)
+{
+    // Ticks are only read for scopes that will be recorded.
+    if (s_depth++ == 0 && s_active.load(std::memory_order_relaxed)) { m_startTick = armGetSystemTick(); }
+}
+
+fslib::trace::Scope::Scope(const fslib::trace::Event &event, const fslib::PathView &path) noexcept
+    : Scope(event)
+{
+    m_path = &path;
+}
+
+fslib::trace::Scope::Scope(const fslib::trace::Event &event,
+                           const fslib::PathView &path,
+                           const fslib::PathView &newPath) noexcept
+    : Scope(event)
+{
+    m_path    = &path;
+    m_newPath = &newPath;
+}
+
+fslib::trace::Scope::Scope(const fslib::trace::Event &event, std::string_view deviceName) noexcept
+    : Scope(event)
+{
+    m_deviceName = deviceName;
+}
+
+fslib::trace::Scope::~Scope() noexcept
+{
+    --s_depth;
+    if (m_startTick == 0) { return; }
+
+    const uint64_t endTick = armGetSystemTick();
+
+    // Paths are written as device:path, with the new path after a separator for renames.
+    char pathBuffer[FS_MAX_PATH * 2 + 64]{};
+    fslib::PathView::Buffer viewBuffer{};
+    size_t pathLength{};
+    const auto append = [&](std::string_view part) {
+        const size_t copyLength = std::min(part.length(), sizeof(pathBuffer) - pathLength);
+        std::memcpy(&pathBuffer[pathLength], part.data(), copyLength);
+        pathLength += copyLength;
+    };
+
+    if (m_path)
+    {
+        append(m_path->get_device_name());
+        append(":");
+        append(m_path->get_path(viewBuffer));
+    }
+
+    if (m_newPath)
+    {
+        append(std::string_view{&PATH_SEPARATOR, 1});
+        append(m_newPath->get_device_name());
+        append(":");
+        append(m_newPath->get_path(viewBuffer));
+    }
+
+    if (!m_deviceName.empty()) { append(m_deviceName); }
+
+    write_record(m_event, m_startTick, endTick, std::string_view{pathBuffer, pathLength});
+}
+
+static bool flush_trace_buffer()
+{
+    if (s_bufferOffset == 0) { return true; }
+
+    const bool writeError =
+        fslib::error::occurred(fsFileWrite(&s_traceFile, s_traceOffset, s_traceBuffer.get(), s_bufferOffset, 0));
+    if (writeError) { return false; }
+
+    s_traceOffset += s_bufferOffset;
+    s_bufferOffset = 0;
+    return true;
+}
+
+static uint32_t get_handle(fslib::trace::Operation operation, const void *handle)
+{
+    if (!handle) { return 0; }
+
+    const bool opening =
+        operation == fslib::trace::Operation::OPEN_FILE || operation == fslib::trace::Operation::OPEN_DIRECTORY;
+    const bool closing =
+        operation == fslib::trace::Operation::CLOSE_FILE || operation == fslib::trace::Operation::CLOSE_DIRECTORY;
+
+    auto findHandle = s_handles.find(handle);
+    if (findHandle == s_handles.end())
+    {
+        // Anything that wasn't opened while tracing is 0 and skipped by replay.
+        if (!opening) { return 0; }
+        findHandle = s_handles.try_emplace(handle, s_nextHandle++).first;
+    }
+
+    const uint32_t handleID = findHandle->second;
+    if (closing) { s_handles.erase(findHandle); }
+
+    return handleID;
+}
+
+static void write_record(const fslib::trace::Event &event, uint64_t startTick, uint64_t endTick, std::string_view path)
+{
+    std::lock_guard<std::mutex> traceGuard{s_traceLock};
+
+    // Tracing could have ended while this call was running.
+    if (!s_active.load(std::memory_order_relaxed) || startTick < s_startTick) { return; }
+
+    const size_t recordSize = sizeof(fslib::trace::Record) + path.length();
+    if (s_bufferOffset + recordSize > TRACE_BUFFER_SIZE && !flush_trace_buffer()) { return; }
+
+    const fslib::trace::Record record = {.timestamp  = armTicksToNs(startTick - s_startTick),
+                                         .duration   = armTicksToNs(endTick - startTick),
+                                         .offset     = event.offset,
+                                         .size       = event.size,
+                                         .handle     = get_handle(event.operation, event.handle),
+                                         .flags      = event.flags,
+                                         .pathLength = static_cast<uint16_t>(path.length()),
+                                         .operation  = event.operation,
+                                         .option     = event.option,
+                                         .reserved   = {0}};
+
+    char *recordOut = &s_traceBuffer[s_bufferOffset];
+    std::memcpy(recordOut, &record, sizeof(fslib::trace::Record));
+    std::memcpy(recordOut + sizeof(fslib::trace::Record), path.data(), path.length());
+    s_bufferOffset += recordSize;
+}
+#endif
@@ -0,0 +1,159 @@
+#include "walk.hpp"
+
+#include "DirectoryReader.hpp"
+#include "WorkerPool.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+
+namespace
+{
+    /// @brief A directory waiting to be read or, in post-order walks, waiting on everything inside of it.
+    struct WalkNode
+    {
+            /// @brief Path of the directory.
+            fslib::Path path;
+
+            /// @brief The directory's own entry. This is what's passed to the visitor in post-order walks.
+            FsDirectoryEntry entry;
+
+            /// @brief Depth of the entries inside of the directory.
+            int depth;
+
+            /// @brief Parent directory. This is only kept for post-order walks.
+            std::shared_ptr<WalkNode> parent;
+
+            /// @brief Reading this directory plus the number of child directories that aren't finished yet.
+            std::atomic<int> pending;
+
+            /// @brief Whether or not the directory couldn't be opened or read all the way through. It isn't visited in
+            /// post-order if so.
+            bool readFailed;
+    };
+
+    /// @brief State shared by everything in a walk.
+    struct WalkState
+    {
+            /// @brief Visitor passed to walk.
+            const fslib::WalkVisitor &visitor;
+
+            /// @brief Whether or not this is a post-order walk.
+            bool postOrder;
+
+            /// @brief Set when the visitor asks to stop.
+            std::atomic<bool> stop;
+
+            /// @brief Set when a directory can't be read.
+            std::atomic<bool> failed;
+    };
+
+    /// @brief Function used to queue a directory to be read.
+    using PushNode = std::function<void(std::shared_ptr<WalkNode>)>;
+} // namespace
+
+/// @brief Reads the directory, visits what's in it and queues its child directories.
+static void read_node(const std::shared_ptr<WalkNode> &node, WalkState &state, const PushNode &pushNode);
+
+/// @brief Marks one thing the node was waiting on as done. Directories that have nothing left are visited for post-order.
+static void finish_node(std::shared_ptr<WalkNode> node, WalkState &state);
+
+bool fslib::walk(const fslib::PathView &root, const fslib::WalkVisitor &visitor, const fslib::WalkOptions &options)
+{
+    if (!root.is_valid()) { return false; }
+
+    WalkState state{.visitor = visitor, .postOrder = options.postOrder, .stop = false, .failed = false};
+
+    auto rootNode     = std::make_shared<WalkNode>();
+    rootNode->path    = fslib::Path{root};
+    rootNode->depth   = 0;
+    rootNode->pending = 1;
+
+    if (options.threadCount <= 1)
+    {
+        std::deque<std::shared_ptr<WalkNode>> nodeQueue{};
+        const PushNode pushNode = [&](std::shared_ptr<WalkNode> node) { nodeQueue.push_back(std::move(node)); };
+
+        nodeQueue.push_back(std::move(rootNode));
+        while (!nodeQueue.empty())
+        {
+            std::shared_ptr<WalkNode> node = std::move(nodeQueue.front());
+            nodeQueue.pop_front();
+            read_node(node, state, pushNode);
+        }
+    }
+    else
+    {
+        WorkerPool pool{options.threadCount};
+        PushNode pushNode{};
+        pushNode = [&](std::shared_ptr<WalkNode> node) {
+            pool.push([&, node]() { read_node(node, state, pushNode); });
+        };
+
+        pushNode(std::move(rootNode));
+        pool.wait();
+    }
+
+    return !state.failed;
+}
+
+static void read_node(const std::shared_ptr<WalkNode> &node, WalkState &state, const PushNode &pushNode)
+{
+    fslib::DirectoryReader reader{};
+    if (!state.stop) { reader.open(node->path); }
+
+    while (!state.stop && reader.read())
+    {
+        for (const FsDirectoryEntry &entry : reader)
+        {
+            fslib::Path entryPath{node->path / entry.name};
+            const bool isDirectory = entry.type == FsDirEntryType_Dir;
+
+            // In post-order, directories are visited once they're finished instead of here.
+            if (!isDirectory || !state.postOrder)
+            {
+                const fslib::WalkAction action = state.visitor(entryPath, entry, node->depth);
+                if (action == fslib::WalkAction::STOP)
+                {
+                    state.stop = true;
+                    break;
+                }
+                if (!isDirectory || action == fslib::WalkAction::SKIP) { continue; }
+            }
+
+            auto childNode     = std::make_shared<WalkNode>();
+            childNode->path    = std::move(entryPath);
+            childNode->entry   = entry;
+            childNode->depth   = node->depth + 1;
+            childNode->pending = 1;
+            if (state.postOrder)
+            {
+                childNode->parent = node;
+                ++node->pending;
+            }
+            pushNode(std::move(childNode));
+        }
+    }
+
+    // A read that fails partway through ends the loop the same way the end of the directory does.
+    node->readFailed = !state.stop && (!reader.is_open() || reader.read_failed());
+    if (node->readFailed) { state.failed = true; }
+
+    // Finishing can visit this directory in post-order and the visitor might delete it, so the handle can't still be open.
+    reader.close();
+    finish_node(node, state);
+}
+
+static void finish_node(std::shared_ptr<WalkNode> node, WalkState &state)
+{
+    if (!state.postOrder) { return; }
+
+    // Whoever finishes the last thing a directory was waiting on visits it and moves up to its parent.
+    while (node && --node->pending == 0)
+    {
+        const bool visit = node->parent && !state.stop && !node->readFailed;
+        if (visit && state.visitor(node->path, node->entry, node->depth - 1) == fslib::WalkAction::STOP) { state.stop = true; }
+
+        node = node->parent;
+    }
+}
@@ -0,0 +1,85 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <chrono>
+#include <memory>
+
+/// @brief Times copy_file against the read then write loop it replaces. The stand-in sleeps on every service call so the
+/// numbers look like a slow device instead of the host's page cache.
+
+namespace
+{
+    /// @brief Size of the file copied.
+    constexpr int64_t FILE_SIZE = 20 * 0x100000;
+
+    /// @brief Size of each read and write, for both copies.
+    constexpr size_t BUFFER_SIZE = 0x40000;
+
+    /// @brief Microseconds every service call sleeps for.
+    constexpr u32 CALL_LATENCY = 2000;
+} // namespace
+
+// Defined at bottom.
+static bool naive_copy(const fslib::PathView &source, const fslib::PathView &destination);
+static double milliseconds_since(std::chrono::steady_clock::time_point begin);
+
+int main()
+{
+    check::make_sd_card();
+
+    const fslib::Path sourcePath{"sdmc:/source.bin"};
+    {
+        auto buffer = std::make_unique<unsigned char[]>(BUFFER_SIZE);
+        fslib::File source{sourcePath, FsOpenMode_Create | FsOpenMode_Write, FILE_SIZE};
+        bool written = source.is_open();
+        for (int64_t offset = 0; written && offset < FILE_SIZE; offset += BUFFER_SIZE)
+        {
+            written = source.write(buffer.get(), BUFFER_SIZE) == static_cast<ssize_t>(BUFFER_SIZE);
+        }
+        check::expect(written, "write the source file");
+    }
+
+    standinSetCallLatency(CALL_LATENCY);
+    std::printf("%lld MB in %zu KB chunks, %u us per service call\n",
+                static_cast<long long>(FILE_SIZE / 0x100000),
+                BUFFER_SIZE / 0x400,
+                CALL_LATENCY);
+
+    const fslib::Path naivePath{"sdmc:/naive.bin"};
+    const auto naiveBegin = std::chrono::steady_clock::now();
+    const bool naiveCopied = naive_copy(sourcePath, naivePath);
+    std::printf("read/write loop: %.0f ms\n", milliseconds_since(naiveBegin));
+
+    const fslib::Path pipelinedPath{"sdmc:/pipelined.bin"};
+    const fslib::CopyOptions options{.bufferSize = BUFFER_SIZE};
+    const auto pipelinedBegin = std::chrono::steady_clock::now();
+    const bool pipelinedCopied = fslib::copy_file(sourcePath, pipelinedPath, options);
+    std::printf("copy_file: %.0f ms\n", milliseconds_since(pipelinedBegin));
+
+    standinSetCallLatency(0);
+    check::expect(naiveCopied && fslib::get_file_size(naivePath) == FILE_SIZE, "read/write loop copied everything");
+    check::expect(pipelinedCopied && fslib::get_file_size(pipelinedPath) == FILE_SIZE, "copy_file copied everything");
+
+    return check::finish();
+}
+
+static bool naive_copy(const fslib::PathView &source, const fslib::PathView &destination)
+{
+    fslib::File sourceFile{source, FsOpenMode_Read};
+    fslib::File destinationFile{destination, FsOpenMode_Create | FsOpenMode_Write, sourceFile.get_size()};
+    if (!sourceFile.is_open() || !destinationFile.is_open()) { return false; }
+
+    auto buffer = std::make_unique<unsigned char[]>(BUFFER_SIZE);
+    ssize_t readCount{};
+    while ((readCount = sourceFile.read(buffer.get(), BUFFER_SIZE)) > 0)
+    {
+        if (destinationFile.write(buffer.get(), readCount) != readCount) { return false; }
+    }
+    return readCount == 0;
+}
+
+static double milliseconds_since(std::chrono::steady_clock::time_point begin)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
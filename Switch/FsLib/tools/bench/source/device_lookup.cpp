@@ -0,0 +1,75 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <chrono>
+#include <string>
+
+/// @brief Times finding a path's file system by searching the device map against using the token the Path carries. Every
+/// operation fslib does starts with one of these. Making a view of a Path is timed too, since that's what passing one costs.
+
+namespace
+{
+    /// @brief Number of devices mapped on top of sdmc.
+    constexpr int DEVICE_COUNT = 32;
+
+    /// @brief Number of times each thing is timed.
+    constexpr int CALL_COUNT = 10000000;
+} // namespace
+
+// Defined at bottom.
+template <typename CallFunction>
+static double time_calls(const char *name, CallFunction call);
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    bool mapped = true;
+    for (int i = 0; i < DEVICE_COUNT && mapped; i++)
+    {
+        FsFileSystem filesystem{};
+        const std::string deviceName = "device" + std::to_string(i);
+        mapped = R_SUCCEEDED(standinOpenDirectoryFileSystem(&filesystem, sdCardRoot.c_str())) &&
+                 fslib::map_file_system(deviceName, filesystem);
+    }
+    check::expect(mapped, "map the devices");
+
+    // The device in the middle so the search isn't lucky either way.
+    const std::string deviceName = "device" + std::to_string(DEVICE_COUNT / 2);
+    const std::string pathString = deviceName + ":/JKSV/config.json";
+    const fslib::Path path{pathString};
+    std::printf("%d devices mapped counting sdmc\n", DEVICE_COUNT + 1);
+
+    // fslib's functions take a PathView and look its device up once per operation, so the views are made up front. Views of
+    // strings have no token and search the map. Views of Paths use the Path's token.
+    const fslib::PathView stringView{pathString};
+    const fslib::PathView pathView{path};
+
+    FsFileSystem *filesystem{};
+    const double byName = time_calls("by name", [&]() {
+        return fslib::get_file_system_by_device_name(deviceName, &filesystem);
+    });
+    const double byString = time_calls("view of a string", [&]() { return fslib::get_file_system(stringView, &filesystem); });
+    const double byToken  = time_calls("view of a Path (token)", [&]() {
+        return fslib::get_file_system(pathView, &filesystem);
+    });
+    check::expect(byName > 0 && byString > 0 && byToken > 0, "every lookup found the device");
+
+    // What passing a Path to any of fslib's functions costs on top of the lookup.
+    time_calls("making a view of a Path", [&]() { return fslib::PathView{path}.get_length() > 0; });
+
+    return check::finish();
+}
+
+template <typename CallFunction>
+static double time_calls(const char *name, CallFunction call)
+{
+    int succeeded{};
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALL_COUNT; i++) { succeeded += call() ? 1 : 0; }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    const double nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / CALL_COUNT;
+    std::printf("%s: %.1f ns each\n", name, nanoseconds);
+    return succeeded == CALL_COUNT ? nanoseconds : -1;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <switch.h>
+
+/// @brief Helpers shared by the host checks. Each check is its own program run against the libnx stand-in in tools/replay.
+/// It prints every expectation and exits with 1 if any of them failed.
+
+namespace check
+{
+    /// @brief Number of expectations that failed so far.
+    inline int s_failures{};
+
+    /// @brief Directory sdmc was pointed at. This is removed by finish.
+    inline std::string s_sdCardRoot{};
+
+    /// @brief Creates an empty directory under /tmp and points sdmc at it. This has to be called before fslib is used.
+    /// @return Path of the directory on the host.
+    inline std::string make_sd_card()
+    {
+        char root[] = "/tmp/fslib_check_XXXXXX";
+        if (!mkdtemp(root))
+        {
+            std::fprintf(stderr, "Unable to create a directory for sdmc.\n");
+            std::exit(1);
+        }
+
+        s_sdCardRoot = root;
+        standinSetSdCardRoot(root);
+        return s_sdCardRoot;
+    }
+
+    /// @brief Prints the result of an expectation and records it if it failed.
+    inline void expect(bool condition, const char *description)
+    {
+        std::printf("%s: %s\n", condition ? "ok" : "FAIL", description);
+        if (!condition) { ++s_failures; }
+    }
+
+    /// @brief Prints a count and whether it matched what was expected.
+    inline void expect_count(uint64_t count, uint64_t expected, const char *description)
+    {
+        std::printf("%s: %s: %llu (expected %llu)\n",
+                    count == expected ? "ok" : "FAIL",
+                    description,
+                    static_cast<unsigned long long>(count),
+                    static_cast<unsigned long long>(expected));
+        if (count != expected) { ++s_failures; }
+    }
+
+    /// @brief Removes the sd card directory and returns what main should return.
+    inline int finish()
+    {
+        std::error_code error{};
+        if (!s_sdCardRoot.empty()) { std::filesystem::remove_all(s_sdCardRoot, error); }
+        return s_failures == 0 ? 0 : 1;
+    }
+} // namespace check
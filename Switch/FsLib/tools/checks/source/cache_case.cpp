@@ -0,0 +1,52 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+/// @brief Checks that the metadata cache doesn't report a file missing when it's asked for with different case than the
+/// listing it came from. The SD card ignores case, so the file service would find it.
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    std::filesystem::create_directory(sdCardRoot + "/JKSV");
+    std::FILE *config = std::fopen((sdCardRoot + "/JKSV/Config.json").c_str(), "w");
+    check::expect(config && std::fclose(config) == 0, "create JKSV/Config.json");
+
+    fslib::enable_metadata_cache("sdmc");
+    {
+        fslib::Directory listing{"sdmc:/JKSV"};
+        check::expect(listing.is_open() && listing.get_count() == 1, "list JKSV");
+    }
+
+    uint64_t startCount = standinGetCallCount();
+    check::expect(fslib::file_exists("sdmc:/JKSV/Config.json"), "Config.json exists");
+    check::expect(fslib::file_exists("sdmc:/JKSV/config.json"), "config.json exists");
+    check::expect(fslib::file_exists("sdmc:/jksv/CONFIG.JSON"), "CONFIG.JSON under jksv exists");
+    check::expect(fslib::directory_exists("sdmc:/jksv"), "jksv exists");
+    check::expect(!fslib::file_exists("sdmc:/JKSV/Missing.json"), "Missing.json doesn't exist");
+    check::expect_count(standinGetCallCount() - startCount, 0, "service calls answered by the listing");
+
+    // Renaming to a different case is the same entry on the SD card.
+    check::expect(fslib::rename_file("sdmc:/JKSV/Config.json", "sdmc:/JKSV/config.json"), "rename to lower case");
+    check::expect(fslib::file_exists("sdmc:/JKSV/CONFIG.json"), "the renamed file exists in any case");
+
+    // Names outside of ASCII aren't folded, so they're left to the file system.
+    startCount = standinGetCallCount();
+    check::expect(!fslib::file_exists("sdmc:/JKSV/\xC3\x84.json"), "a missing non-ASCII name doesn't exist");
+    check::expect_count(standinGetCallCount() - startCount, 1, "service calls for a non-ASCII name");
+
+    // Without folding, a different case is a different name and isn't known until it's asked for.
+    fslib::enable_metadata_cache("sdmc", true, false);
+    {
+        fslib::Directory listing{"sdmc:/JKSV"};
+        check::expect(listing.is_open(), "list JKSV again");
+    }
+    check::expect(fslib::file_exists("sdmc:/JKSV/config.json"), "config.json exists with case kept");
+    check::expect(!fslib::file_exists("sdmc:/JKSV/Config.json"), "Config.json doesn't exist with case kept");
+
+    return check::finish();
+}
@@ -0,0 +1,34 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+/// @brief Copies with a buffer size of zero. The size has to be raised to something that can make progress instead of the
+/// copy failing without an error and leaving a preallocated destination behind.
+
+namespace
+{
+    /// @brief Size of every file copied. This is bigger than the smallest buffer, so it takes more than one read.
+    constexpr int64_t FILE_SIZE = 0x3000;
+} // namespace
+
+int main()
+{
+    check::make_sd_card();
+
+    const fslib::Path sourceRoot{"sdmc:/source"};
+    const fslib::Path largePath{sourceRoot / "large.bin"};
+    const bool created = fslib::create_directory(sourceRoot) && fslib::create_file(sourceRoot / "small.bin", FILE_SIZE) &&
+                         fslib::create_file(largePath, FILE_SIZE * 4);
+    check::expect(created, "create the source tree");
+
+    const fslib::CopyOptions options{.bufferSize = 0, .smallFileSize = FILE_SIZE, .splitSize = FILE_SIZE};
+    const bool fileCopied = fslib::copy_file(largePath, "sdmc:/large.bin", options);
+    check::expect(fileCopied && fslib::get_file_size("sdmc:/large.bin") == FILE_SIZE * 4, "copy_file with a zero buffer");
+
+    // The small file is batched and the large one is split, so both paths through the pool get a zero buffer.
+    const bool directoryCopied = fslib::copy_directory_recursively(sourceRoot, "sdmc:/destination", options);
+    const bool sizesMatch      = fslib::get_file_size("sdmc:/destination/small.bin") == FILE_SIZE &&
+                                   fslib::get_file_size("sdmc:/destination/large.bin") == FILE_SIZE * 4;
+    check::expect(directoryCopied && sizesMatch, "copy_directory_recursively with a zero buffer");
+
+    return check::finish();
+}
@@ -0,0 +1,71 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <filesystem>
+#include <string>
+
+/// @brief Counts the fs service calls create_directories_recursively makes and checks that it doesn't trust directories it
+/// created earlier unless the metadata cache is on.
+
+// Defined at bottom.
+static uint64_t create_siblings(const fslib::Path &parent, const char *prefix, int count, bool &createdOut);
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    const fslib::Path parentPath{"sdmc:/a/b/c/d/e"};
+    const fslib::Path deepPath{"sdmc:/a/b/c/d/e/f"};
+    check::expect(fslib::create_directories_recursively(parentPath), "create the first five levels");
+
+    uint64_t startCount = standinGetCallCount();
+    check::expect(fslib::create_directories_recursively(deepPath), "create the sixth level");
+    check::expect_count(standinGetCallCount() - startCount, 3, "service calls with only the last level missing");
+
+    // Nothing is trusted with the cache off, so this has to be noticed and the directory created again.
+    std::filesystem::remove(sdCardRoot + "/a/b/c/d/e/f");
+    check::expect(fslib::create_directories_recursively(deepPath), "create a directory removed outside of fslib");
+    check::expect(std::filesystem::is_directory(sdCardRoot + "/a/b/c/d/e/f"), "the removed directory was created again");
+
+    constexpr int SIBLING_COUNT = 100;
+    bool created{};
+    uint64_t callCount = create_siblings(parentPath, "cold", SIBLING_COUNT, created);
+    check::expect(created, "create siblings with the cache off");
+    check::expect_count(callCount, SIBLING_COUNT * 3, "service calls for 100 siblings with the cache off");
+
+    // The first sibling finds the parent. Everything after that only costs what's new.
+    fslib::enable_metadata_cache("sdmc");
+    check::expect(fslib::create_directories_recursively(parentPath / "warm"), "find the parent with the cache on");
+    callCount = create_siblings(parentPath, "known", SIBLING_COUNT, created);
+    check::expect(created, "create siblings with the cache on");
+    check::expect_count(callCount, SIBLING_COUNT * 2, "service calls for 100 siblings under a known parent");
+
+    // The first call finds the path exists and remembers it.
+    startCount = standinGetCallCount();
+    check::expect(fslib::create_directories_recursively(deepPath), "create a path that already exists");
+    check::expect_count(standinGetCallCount() - startCount, 1, "service calls for a path that already exists");
+
+    startCount = standinGetCallCount();
+    check::expect(fslib::create_directories_recursively(deepPath), "create a path that's known to exist");
+    check::expect_count(standinGetCallCount() - startCount, 0, "service calls for a path that's known to exist");
+
+    // Turning the cache off forgets everything it knew.
+    fslib::enable_metadata_cache("sdmc", false);
+    std::filesystem::remove(sdCardRoot + "/a/b/c/d/e/f");
+    check::expect(fslib::create_directories_recursively(deepPath), "create a removed directory after the cache is off");
+    check::expect(std::filesystem::is_directory(sdCardRoot + "/a/b/c/d/e/f"), "the directory was created again");
+
+    return check::finish();
+}
+
+static uint64_t create_siblings(const fslib::Path &parent, const char *prefix, int count, bool &createdOut)
+{
+    createdOut = true;
+    const uint64_t startCount = standinGetCallCount();
+    for (int i = 0; i < count; i++)
+    {
+        const std::string name = prefix + std::to_string(i);
+        if (!fslib::create_directories_recursively(parent / name)) { createdOut = false; }
+    }
+    return standinGetCallCount() - startCount;
+}
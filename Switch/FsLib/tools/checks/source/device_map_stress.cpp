@@ -0,0 +1,86 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <atomic>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+/// @brief Maps and closes devices over and over while other threads look them up and do I/O on sdmc. Nothing here can crash or
+/// fail to map, but this is mostly meant for make FSLIB_TSAN=1 run, where ThreadSanitizer reports any race on the registry.
+/// @note The workers don't do I/O on the devices being closed. Closing a file system another thread is using is a bug on the
+/// Switch too, and ThreadSanitizer rightly reports it.
+
+namespace
+{
+    /// @brief Number of times the main thread maps and closes the devices.
+    constexpr int MAP_COUNT = 2000;
+
+    /// @brief Number of threads doing lookups and I/O while that happens.
+    constexpr int WORKER_COUNT = 4;
+
+    /// @brief Names the main thread cycles through. Using more than one makes new tables get published, not just records
+    /// being updated.
+    constexpr const char *DEVICE_NAMES[] = {"work", "work1", "work2", "work3"};
+} // namespace
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+    const std::string workRoot   = sdCardRoot + "/work";
+    mkdir(workRoot.c_str(), 0755);
+
+    std::atomic<bool> done{};
+    std::atomic<uint64_t> workDone{};
+    std::vector<std::thread> workers{};
+    for (int i = 0; i < WORKER_COUNT; i++)
+    {
+        workers.emplace_back([&, i]() {
+            const fslib::Path filePath{"sdmc:/worker" + std::to_string(i) + ".txt"};
+            const fslib::Path devicePath{std::string{DEVICE_NAMES[i]} + ":/file.txt"};
+            while (!done)
+            {
+                // These can fail when the device is closed at the wrong moment. They just can't race.
+                FsFileSystem *filesystem{};
+                fslib::get_file_system_by_device_name(DEVICE_NAMES[i], &filesystem);
+                fslib::get_file_system(devicePath, &filesystem);
+                {
+                    fslib::File file{filePath, FsOpenMode_Create | FsOpenMode_Write};
+                    if (file.is_open() && file.writef("%d", i)) { ++workDone; }
+                }
+                fslib::file_exists(filePath);
+                fslib::get_file_size(filePath);
+            }
+        });
+    }
+
+    bool mapped = true, closed = true;
+    for (int i = 0; i < MAP_COUNT && mapped && closed; i++)
+    {
+        for (const char *deviceName : DEVICE_NAMES)
+        {
+            FsFileSystem filesystem{};
+            mapped = mapped && R_SUCCEEDED(standinOpenDirectoryFileSystem(&filesystem, workRoot.c_str())) &&
+                     fslib::map_file_system(deviceName, filesystem);
+        }
+
+        // Give the workers a moment with the device mapped.
+        std::this_thread::yield();
+        for (const char *deviceName : DEVICE_NAMES) { closed = fslib::close_file_system(deviceName) && closed; }
+    }
+
+    done = true;
+    for (std::thread &worker : workers) { worker.join(); }
+
+    check::expect(mapped, "map the devices every time");
+    check::expect(closed, "close the devices every time");
+    check::expect(workDone > 0, "workers wrote to sdmc during the remaps");
+
+    FsFileSystem filesystem{};
+    const bool remapped = R_SUCCEEDED(standinOpenDirectoryFileSystem(&filesystem, workRoot.c_str())) &&
+                          fslib::map_file_system("work", filesystem);
+    check::expect(remapped && fslib::create_file("work:/file.txt"), "device works after the stress");
+
+    return check::finish();
+}
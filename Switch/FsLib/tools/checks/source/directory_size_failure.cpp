@@ -0,0 +1,39 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <string>
+
+/// @brief Fails reading a directory while get_directory_size walks it. The size has to be reported as a failure and the partial
+/// total can't end up in the cache.
+
+namespace
+{
+    /// @brief Number of files created under the directory. This needs more than one batch of DirectoryReader.
+    constexpr int FILE_COUNT = 0x100;
+
+    /// @brief Size of every file created.
+    constexpr int64_t FILE_SIZE = 0x10;
+} // namespace
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    const fslib::Path root{"sdmc:/sizes"};
+    bool created = fslib::create_directory(root);
+    for (int i = 0; created && i < FILE_COUNT; i++)
+    {
+        created = fslib::create_file(root / ("file" + std::to_string(i) + ".bin"), FILE_SIZE);
+    }
+    check::expect(created, "create the directory");
+
+    const fslib::DirectorySizeOptions options{.threadCount = 1, .useCache = true};
+    standinFailDirectoryReads((sdCardRoot + "/sizes").c_str(), 1);
+    check::expect(fslib::get_directory_size(root, options) == -1, "size fails when a read fails");
+
+    // If the partial total had been cached, it'd be returned here without reading anything.
+    standinFailDirectoryReads(nullptr, 0);
+    check::expect_count(fslib::get_directory_size(root, options), FILE_COUNT * FILE_SIZE, "size once reads work again");
+
+    return check::finish();
+}
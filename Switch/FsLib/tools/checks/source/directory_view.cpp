@@ -0,0 +1,45 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <cstring>
+#include <string>
+
+/// @brief Checks that DirectoryView::get_entry hands back an empty entry instead of reading out of range.
+
+int main()
+{
+    check::make_sd_card();
+
+    {
+        // Nothing is open, so there's no page size to divide by.
+        fslib::DirectoryView closedView{};
+        check::expect(std::strlen(closedView.get_entry(0).get_filename()) == 0, "get_entry on a default constructed view");
+
+        fslib::DirectoryView missingView{fslib::Path{"sdmc:/missing"}, 8};
+        check::expect(!missingView.is_open(), "opening a directory that doesn't exist fails");
+        check::expect(std::strlen(missingView.get_entry(3).get_filename()) == 0, "get_entry on a view that failed to open");
+    }
+
+    constexpr int ENTRY_COUNT = 20;
+    const fslib::Path viewPath{"sdmc:/view"};
+    check::expect(fslib::create_directory(viewPath), "create the directory to view");
+    int createdCount{};
+    for (int i = 0; i < ENTRY_COUNT; i++)
+    {
+        const std::string fileName = "/file" + std::to_string(i);
+        fslib::File file{viewPath / fileName, FsOpenMode_Create | FsOpenMode_Write};
+        if (file.is_open()) { ++createdCount; }
+    }
+    check::expect(createdCount == ENTRY_COUNT, "create the files in the directory");
+
+    {
+        fslib::DirectoryView view{viewPath, 8, true};
+        check::expect(view.is_open() && view.get_count() == ENTRY_COUNT, "open the view");
+        check::expect(std::strcmp(view.get_entry(0).get_filename(), "file0") == 0, "first entry in natural order");
+        check::expect(std::strcmp(view.get_entry(19).get_filename(), "file19") == 0, "last entry in natural order");
+        check::expect(std::strlen(view.get_entry(-1).get_filename()) == 0, "get_entry with a negative index");
+        check::expect(std::strlen(view.get_entry(ENTRY_COUNT).get_filename()) == 0, "get_entry past the last entry");
+    }
+
+    return check::finish();
+}
@@ -0,0 +1,49 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+/// @brief Checks that paths without a slash after the device, like sdmc:file, are accepted and get one before they reach the
+/// file system.
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    fslib::PathView::Buffer pathBuffer{};
+    const fslib::PathView filePath{"sdmc:file.txt"};
+    check::expect(filePath.is_valid(), "sdmc:file.txt is valid");
+    check::expect(std::strcmp(filePath.get_path(pathBuffer), "/file.txt") == 0, "get_path adds the slash");
+    check::expect(filePath.string() == "sdmc:/file.txt", "string adds the slash");
+    check::expect(std::strcmp(fslib::Path{filePath}.get_path(), "/file.txt") == 0, "Path made from the view has the slash");
+
+    // Not NULL terminated and with trailing slashes to trim.
+    const std::string_view directoryString{"sdmc:dir/sub//tail"};
+    const fslib::PathView directoryPath{directoryString.substr(0, 13)};
+    check::expect(directoryPath.is_valid(), "view of part of a string is valid");
+    check::expect(std::strcmp(directoryPath.get_path(pathBuffer), "/dir/sub") == 0, "get_path trims and adds the slash");
+    check::expect(std::strcmp(directoryPath.sub_path(3).get_path(pathBuffer), "/dir") == 0, "sub_path keeps the slash");
+
+    check::expect(!fslib::PathView{"file.txt"}.is_valid(), "a path without a device is invalid");
+
+    {
+        fslib::File file{filePath, FsOpenMode_Create | FsOpenMode_Write};
+        check::expect(file.is_open(), "create a file without the slash");
+    }
+    check::expect(std::filesystem::is_regular_file(sdCardRoot + "/file.txt"), "the file is at the root of sdmc");
+    check::expect(fslib::file_exists("sdmc:/file.txt"), "the file exists with the slash");
+
+    check::expect(fslib::create_directories_recursively("sdmc:a/b/c"), "create directories without the slash");
+    check::expect(std::filesystem::is_directory(sdCardRoot + "/a/b/c"), "the directories are at the root of sdmc");
+    check::expect(fslib::create_directories_recursively("sdmc:a/b/d"), "create a sibling without the slash");
+    check::expect(std::filesystem::is_directory(sdCardRoot + "/a/b/d"), "the sibling was created");
+
+    // A single character path isn't the root.
+    check::expect(fslib::create_directory("sdmc:x") && fslib::delete_directory_recursively("sdmc:x"), "delete sdmc:x");
+    check::expect(!std::filesystem::exists(sdCardRoot + "/x"), "sdmc:x itself was deleted");
+
+    return check::finish();
+}
@@ -0,0 +1,82 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <cstdio>
+#include <string>
+
+/// @brief Counts the fs service calls File's read buffer makes for get_byte, read_line and seek.
+
+// Defined at bottom.
+static bool write_lines(const fslib::PathView &filePath, int lineCount);
+
+int main()
+{
+    check::make_sd_card();
+
+    // Nine bytes a line, so the whole file fits in the default buffer.
+    constexpr int LINE_COUNT = 1000;
+    const fslib::Path linesPath{"sdmc:/lines.txt"};
+    check::expect(write_lines(linesPath, LINE_COUNT), "write the test file");
+
+    {
+        fslib::File lines{linesPath, FsOpenMode_Read};
+        check::expect(lines.is_open(), "open for reading");
+
+        uint64_t startCount = standinGetCallCount();
+        int64_t byteCount{};
+        while (lines.get_byte() != -1) { ++byteCount; }
+        check::expect(byteCount == LINE_COUNT * 9, "get_byte reads every byte");
+        check::expect_count(standinGetCallCount() - startCount, 1, "service calls for every byte with get_byte");
+
+        // Seeking inside of the buffer doesn't drop it.
+        startCount = standinGetCallCount();
+        lines.seek(0, fslib::Stream::Origin::BEGINNING);
+        std::string line{};
+        int lineCount{};
+        while (lines.read_line(line)) { ++lineCount; }
+        check::expect(lineCount == LINE_COUNT, "read_line reads every line");
+        check::expect_count(standinGetCallCount() - startCount, 0, "service calls for every line after seeking back");
+    }
+
+    {
+        // Without a buffer, every byte is its own read.
+        fslib::File unbuffered{linesPath, FsOpenMode_Read, 0, 0};
+        const uint64_t startCount = standinGetCallCount();
+        for (int i = 0; i < 100; i++) { unbuffered.get_byte(); }
+        check::expect_count(standinGetCallCount() - startCount, 100, "service calls for 100 unbuffered get_byte calls");
+    }
+
+    // Three buffers worth of data to seek around in.
+    constexpr int LARGE_LINE_COUNT = 0x30000 / 9;
+    const fslib::Path largePath{"sdmc:/large.txt"};
+    check::expect(write_lines(largePath, LARGE_LINE_COUNT), "write the large test file");
+
+    {
+        fslib::File large{largePath, FsOpenMode_Read};
+        uint64_t startCount = standinGetCallCount();
+        large.seek(150000, fslib::Stream::Origin::BEGINNING);
+        large.get_byte();
+        check::expect_count(standinGetCallCount() - startCount, 1, "service calls for get_byte after seeking past the buffer");
+
+        startCount = standinGetCallCount();
+        large.seek(150100, fslib::Stream::Origin::BEGINNING);
+        large.get_byte();
+        large.seek(-50, fslib::Stream::Origin::CURRENT);
+        large.get_byte();
+        check::expect_count(standinGetCallCount() - startCount, 0, "service calls for get_byte after seeking in the buffer");
+    }
+
+    return check::finish();
+}
+
+static bool write_lines(const fslib::PathView &filePath, int lineCount)
+{
+    fslib::File file{filePath, FsOpenMode_Create | FsOpenMode_Write};
+    if (!file.is_open()) { return false; }
+
+    for (int i = 0; i < lineCount; i++)
+    {
+        if (!file.writef("line %03d\n", i % 1000)) { return false; }
+    }
+    return file.flush();
+}
@@ -0,0 +1,36 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <cstring>
+
+/// @brief Reads a file through SequentialReader with a chunk size of zero. The size has to be raised to something that can
+/// make progress instead of leaving the read ahead thread spinning on empty chunks.
+
+namespace
+{
+    /// @brief Size of the test file.
+    constexpr int FILE_SIZE = 0x1000;
+} // namespace
+
+int main()
+{
+    check::make_sd_card();
+
+    const fslib::Path filePath{"sdmc:/sequential.bin"};
+    unsigned char written[FILE_SIZE]{};
+    for (int i = 0; i < FILE_SIZE; i++) { written[i] = static_cast<unsigned char>(i * 7); }
+    {
+        fslib::File file{filePath, FsOpenMode_Create | FsOpenMode_Write};
+        check::expect(file.is_open() && file.write(written, FILE_SIZE) == FILE_SIZE, "write the test file");
+    }
+
+    fslib::File file{filePath, FsOpenMode_Read};
+    fslib::SequentialReader reader{file, 0};
+    check::expect(reader.is_open(), "open with a chunk size of zero");
+
+    unsigned char read[FILE_SIZE]{};
+    check::expect_count(reader.read(read, FILE_SIZE), FILE_SIZE, "bytes read");
+    check::expect(std::memcmp(read, written, FILE_SIZE) == 0 && reader.end_of_stream(), "read the whole file back");
+
+    return check::finish();
+}
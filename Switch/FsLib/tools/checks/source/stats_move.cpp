@@ -0,0 +1,62 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <utility>
+
+/// @brief Checks that Files and DirectoryReaders keep recording stats after they're moved. Run with make FSLIB_STATS=1.
+
+// Defined at bottom.
+static fslib::stats::DeviceStats get_sd_card_stats();
+
+int main()
+{
+    check::make_sd_card();
+    if (!fslib::stats::is_enabled())
+    {
+        std::printf("skipped: fslib was built without stats\n");
+        return check::finish();
+    }
+
+    const fslib::Path filePath{"sdmc:/stats.txt"};
+    {
+        fslib::File file{filePath, FsOpenMode_Create | FsOpenMode_Write};
+        check::expect(file.is_open() && file.writef("%s", "stats stats stats"), "write the test file");
+    }
+
+    fslib::stats::reset();
+    {
+        fslib::File opened{filePath, FsOpenMode_Read};
+        fslib::File moved{std::move(opened)};
+        fslib::File assigned{};
+        assigned = std::move(moved);
+        check::expect(assigned.get_byte() != -1, "read from the moved file");
+    }
+
+    const fslib::Path directoryPath{"sdmc:/"};
+    {
+        fslib::DirectoryReader opened{directoryPath};
+        fslib::DirectoryReader moved{std::move(opened)};
+        fslib::DirectoryReader assigned{};
+        assigned = std::move(moved);
+        check::expect(assigned.read(), "read from the moved directory reader");
+    }
+
+    const fslib::stats::DeviceStats sdCardStats = get_sd_card_stats();
+    const auto &operations                      = sdCardStats.operations;
+    check::expect_count(operations[static_cast<size_t>(fslib::stats::Operation::READ)].calls, 1, "file reads recorded");
+    check::expect_count(sdCardStats.bytesRead, 17, "bytes read recorded");
+    check::expect_count(operations[static_cast<size_t>(fslib::stats::Operation::DIR_READ)].calls,
+                        1,
+                        "directory reads recorded");
+
+    return check::finish();
+}
+
+static fslib::stats::DeviceStats get_sd_card_stats()
+{
+    for (const fslib::stats::DeviceStats &deviceStats : fslib::stats::get_snapshot())
+    {
+        if (deviceStats.deviceName == "sdmc") { return deviceStats; }
+    }
+    return {};
+}
@@ -0,0 +1,56 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <atomic>
+#include <string>
+
+/// @brief Deletes a nested tree from a post-order walk. Deleting a directory fails while a handle to it is open, so this only
+/// works if every directory is closed before it's visited.
+
+// Defined at bottom.
+static bool make_tree(const fslib::Path &root, int depth);
+
+int main()
+{
+    check::make_sd_card();
+
+    for (const int threadCount : {1, 4})
+    {
+        const fslib::Path root{"sdmc:/tree"};
+        check::expect(fslib::create_directory(root) && make_tree(root, 4), "create the tree");
+
+        std::atomic<int> deleteCount{};
+        std::atomic<int> failedCount{};
+        const fslib::WalkOptions options{.threadCount = threadCount, .postOrder = true};
+        const bool walked = fslib::walk(
+            root,
+            [&](const fslib::Path &entryPath, const FsDirectoryEntry &entry, int) {
+                const bool isDirectory = entry.type == FsDirEntryType_Dir;
+                const bool deleted = isDirectory ? fslib::delete_directory(entryPath) : fslib::delete_file(entryPath);
+                ++(deleted ? deleteCount : failedCount);
+                return fslib::WalkAction::CONTINUE;
+            },
+            options);
+
+        const std::string threads = " with " + std::to_string(threadCount) + " thread(s)";
+        check::expect(walked, ("walk the tree" + threads).c_str());
+        check::expect_count(failedCount, 0, ("deletes that failed" + threads).c_str());
+        check::expect(fslib::delete_directory(root), ("only the root is left" + threads).c_str());
+    }
+
+    return check::finish();
+}
+
+static bool make_tree(const fslib::Path &root, int depth)
+{
+    if (depth == 0) { return true; }
+
+    for (const char *name : {"a", "b"})
+    {
+        const fslib::Path directoryPath{root / name};
+        const fslib::Path filePath{directoryPath / "file.txt"};
+        const bool created = fslib::create_directory(directoryPath) && fslib::create_file(filePath);
+        if (!created || !make_tree(directoryPath, depth - 1)) { return false; }
+    }
+    return true;
+}
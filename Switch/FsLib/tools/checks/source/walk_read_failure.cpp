@@ -0,0 +1,68 @@
+#include "check.hpp"
+#include "fslib.hpp"
+
+#include <atomic>
+#include <string>
+
+/// @brief Fails reading a directory partway through a walk. The walk has to report it, and a post-order walk can't visit the
+/// directory it didn't finish reading since the visitor would act on it as if everything inside had been handled.
+
+namespace
+{
+    /// @brief Number of files created in the failing directory. This needs more than one batch of DirectoryReader.
+    constexpr int FILE_COUNT = 0x100;
+} // namespace
+
+int main()
+{
+    const std::string sdCardRoot = check::make_sd_card();
+
+    const fslib::Path root{"sdmc:/tree"};
+    const fslib::Path brokenPath{root / "broken"};
+    bool created = fslib::create_directory(root) && fslib::create_directory(brokenPath);
+    for (int i = 0; created && i < FILE_COUNT; i++)
+    {
+        created = fslib::create_file(brokenPath / ("file" + std::to_string(i) + ".bin"));
+    }
+    check::expect(created, "create the tree");
+
+    for (const bool postOrder : {false, true})
+    {
+        for (const int threadCount : {1, 4})
+        {
+            standinFailDirectoryReads((sdCardRoot + "/tree/broken").c_str(), 1);
+
+            std::atomic<int> visitCount{};
+            std::atomic<bool> brokenVisited{};
+            const fslib::WalkOptions options{.threadCount = threadCount, .postOrder = postOrder};
+            const bool walked = fslib::walk(
+                root,
+                [&](const fslib::Path &entryPath, const FsDirectoryEntry &entry, int) {
+                    ++visitCount;
+                    if (entry.type == FsDirEntryType_Dir) { brokenVisited = true; }
+                    return fslib::WalkAction::CONTINUE;
+                },
+                options);
+
+            const std::string walkName =
+                std::string{postOrder ? "post-order" : "pre-order"} + " with " + std::to_string(threadCount) + " thread(s)";
+            check::expect(!walked, ("walk reports the failed read in " + walkName).c_str());
+            check::expect(visitCount < FILE_COUNT, ("walk stopped reading the broken directory in " + walkName).c_str());
+            const char *visitName = postOrder ? "broken directory isn't visited in " : "broken directory is visited in ";
+            check::expect(brokenVisited != postOrder, (visitName + walkName).c_str());
+        }
+    }
+
+    // A listing that stops partway through isn't a listing.
+    standinFailDirectoryReads((sdCardRoot + "/tree/broken").c_str(), 1);
+    fslib::Directory brokenDirectory{brokenPath};
+    check::expect(!brokenDirectory.is_open() && brokenDirectory.get_count() == 0, "partial listing fails to open");
+
+    standinFailDirectoryReads(nullptr, 0);
+    const bool walked = fslib::walk(root, [](const fslib::Path &, const FsDirectoryEntry &, int) {
+        return fslib::WalkAction::CONTINUE;
+    });
+    check::expect(walked, "walk works once reads stop failing");
+
+    return check::finish();
+}
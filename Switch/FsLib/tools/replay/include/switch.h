@@ -0,0 +1,266 @@
+#pragma once
+#include <dirent.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Stand-in for the parts of libnx fslib uses so it can be built and run on a PC. File systems are directories on the
+/// host. Types and values match libnx where fslib depends on them. Anything that only exists on a Switch fails with
+/// RESULT_NOT_IMPLEMENTED below.
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int32_t s32;
+typedef int64_t s64;
+typedef u32 Result;
+
+#define BIT(n) (1U << (n))
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res)    ((res) != 0)
+#define R_MODULE(res)    ((res) & 0x1FF)
+#define R_DESCRIPTION(res) (((res) >> 9) & 0x1FFF)
+#define R_VALUE(res)     ((res) & 0x3FFFFF)
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+
+enum
+{
+    Module_Fs = 2
+};
+
+#define FS_MAX_PATH 0x301
+
+typedef struct
+{
+        u64 uid[2];
+} AccountUid;
+
+/// @brief Host directory the file system is rooted at.
+typedef struct
+{
+        int root;
+} FsFileSystem;
+
+typedef struct
+{
+        int fd;
+        u32 mode;
+} FsFile;
+
+typedef struct
+{
+        DIR *dir;
+        u32 mode;
+} FsDir;
+
+typedef struct
+{
+        int fd;
+} FsStorage;
+
+typedef struct
+{
+        u32 unused;
+} FsDeviceOperator;
+
+typedef struct
+{
+        u32 unused;
+} FsSaveDataInfoReader;
+
+typedef enum
+{
+    FsDirEntryType_Dir  = 0,
+    FsDirEntryType_File = 1
+} FsDirEntryType;
+
+typedef struct
+{
+        char name[FS_MAX_PATH];
+        u8 pad[3];
+        s8 type;
+        u8 pad2[3];
+        s64 file_size;
+} FsDirectoryEntry;
+
+typedef enum
+{
+    FsOpenMode_Read   = BIT(0),
+    FsOpenMode_Write  = BIT(1),
+    FsOpenMode_Append = BIT(2)
+} FsOpenMode;
+
+typedef enum
+{
+    FsDirOpenMode_ReadDirs   = BIT(0),
+    FsDirOpenMode_ReadFiles  = BIT(1),
+    FsDirOpenMode_NoFileSize = BIT(31)
+} FsDirOpenMode;
+
+typedef enum
+{
+    FsSaveDataSpaceId_System   = 0,
+    FsSaveDataSpaceId_User     = 1,
+    FsSaveDataSpaceId_SdSystem = 2,
+    FsSaveDataSpaceId_All      = 0xFF
+} FsSaveDataSpaceId;
+
+typedef enum
+{
+    FsSaveDataRank_Primary   = 0,
+    FsSaveDataRank_Secondary = 1
+} FsSaveDataRank;
+
+typedef enum
+{
+    FsSaveDataType_System     = 0,
+    FsSaveDataType_Account    = 1,
+    FsSaveDataType_Bcat       = 2,
+    FsSaveDataType_Device     = 3,
+    FsSaveDataType_Temporary  = 4,
+    FsSaveDataType_Cache      = 5,
+    FsSaveDataType_SystemBcat = 6
+} FsSaveDataType;
+
+typedef enum
+{
+    FsBisPartitionId_User = 30
+} FsBisPartitionId;
+
+typedef struct
+{
+        u64 application_id;
+        AccountUid uid;
+        u64 system_save_data_id;
+        u8 save_data_type;
+        u8 save_data_rank;
+        u16 save_data_index;
+        u32 pad_x24;
+        u64 unk_x28;
+        u64 unk_x30;
+        u64 unk_x38;
+} FsSaveDataAttribute;
+
+typedef struct
+{
+        u64 save_data_id;
+        u8 save_data_space_id;
+        u8 save_data_type;
+        u8 pad[6];
+        AccountUid uid;
+        u64 system_save_data_id;
+        u64 application_id;
+        u64 size;
+        u16 save_data_index;
+        u8 save_data_rank;
+        u8 unk_x3b[0x25];
+} FsSaveDataInfo;
+
+typedef struct
+{
+        bool filter_by_application_id;
+        bool filter_by_save_data_type;
+        bool filter_by_user_id;
+        bool filter_by_system_save_data_id;
+        bool filter_by_index;
+        u8 save_data_rank;
+        u8 padding[2];
+        FsSaveDataAttribute attr;
+} FsSaveDataFilter;
+
+typedef struct
+{
+        u64 created;
+        u64 modified;
+        u64 accessed;
+        u8 is_valid;
+        u8 padding[7];
+} FsTimeStampRaw;
+
+/// @brief Returned by everything that only exists on a Switch.
+#define RESULT_NOT_IMPLEMENTED MAKERESULT(Module_Fs, 3001)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    /// @brief Sets the host directory fsOpenSdCardFileSystem opens. This must be called before fslib is first used.
+    void standinSetSdCardRoot(const char *root);
+
+    /// @brief Opens a host directory as a file system that can be mapped with fslib::map_file_system.
+    Result standinOpenDirectoryFileSystem(FsFileSystem *filesystem, const char *root);
+
+    /// @brief Returns the number of fsFs, fsFile and fsDir calls made so far.
+    u64 standinGetCallCount(void);
+
+    /// @brief Makes every fsFs, fsFile and fsDir call sleep for this many microseconds first, like a slow device would. 0
+    /// turns it off.
+    void standinSetCallLatency(u32 microseconds);
+
+    /// @brief Makes fsDirRead fail on the host directory at hostPath after readsBeforeFailure reads of it have worked. Reads
+    /// keep failing until this is called again. Passing nullptr stops the failures.
+    void standinFailDirectoryReads(const char *hostPath, u32 readsBeforeFailure);
+
+    Result fsOpenSdCardFileSystem(FsFileSystem *filesystem);
+    Result fsFsOpenFile(FsFileSystem *filesystem, const char *path, u32 mode, FsFile *file);
+    Result fsFsCreateFile(FsFileSystem *filesystem, const char *path, s64 size, u32 option);
+    Result fsFsDeleteFile(FsFileSystem *filesystem, const char *path);
+    Result fsFsCreateDirectory(FsFileSystem *filesystem, const char *path);
+    Result fsFsDeleteDirectory(FsFileSystem *filesystem, const char *path);
+    Result fsFsDeleteDirectoryRecursively(FsFileSystem *filesystem, const char *path);
+    Result fsFsCleanDirectoryRecursively(FsFileSystem *filesystem, const char *path);
+    Result fsFsRenameFile(FsFileSystem *filesystem, const char *oldPath, const char *newPath);
+    Result fsFsRenameDirectory(FsFileSystem *filesystem, const char *oldPath, const char *newPath);
+    Result fsFsGetEntryType(FsFileSystem *filesystem, const char *path, FsDirEntryType *type);
+    Result fsFsOpenDirectory(FsFileSystem *filesystem, const char *path, u32 mode, FsDir *directory);
+    Result fsFsGetFreeSpace(FsFileSystem *filesystem, const char *path, s64 *out);
+    Result fsFsGetTotalSpace(FsFileSystem *filesystem, const char *path, s64 *out);
+    Result fsFsGetFileTimeStampRaw(FsFileSystem *filesystem, const char *path, FsTimeStampRaw *out);
+    Result fsFsCommit(FsFileSystem *filesystem);
+    void fsFsClose(FsFileSystem *filesystem);
+
+    Result fsFileRead(FsFile *file, s64 offset, void *buffer, u64 readSize, u32 option, u64 *bytesRead);
+    Result fsFileWrite(FsFile *file, s64 offset, const void *buffer, u64 writeSize, u32 option);
+    Result fsFileFlush(FsFile *file);
+    Result fsFileSetSize(FsFile *file, s64 size);
+    Result fsFileGetSize(FsFile *file, s64 *out);
+    void fsFileClose(FsFile *file);
+
+    Result fsDirRead(FsDir *directory, s64 *totalEntries, size_t maxEntries, FsDirectoryEntry *buffer);
+    Result fsDirGetEntryCount(FsDir *directory, s64 *count);
+    void fsDirClose(FsDir *directory);
+
+    Result fsStorageRead(FsStorage *storage, s64 offset, void *buffer, u64 size);
+    Result fsStorageGetSize(FsStorage *storage, s64 *out);
+    void fsStorageClose(FsStorage *storage);
+
+    Result fsOpenBisStorage(FsStorage *storage, FsBisPartitionId partitionId);
+    Result fsOpenBisFileSystem(FsFileSystem *filesystem, FsBisPartitionId partitionId, const char *path);
+    Result fsOpenSaveDataFileSystem(FsFileSystem *filesystem, FsSaveDataSpaceId spaceId, const FsSaveDataAttribute *attr);
+    Result fsOpenSaveDataFileSystemBySystemSaveDataId(FsFileSystem *filesystem,
+                                                      FsSaveDataSpaceId spaceId,
+                                                      const FsSaveDataAttribute *attr);
+    Result fsOpenSaveDataInfoReader(FsSaveDataInfoReader *reader, FsSaveDataSpaceId spaceId);
+    Result fsOpenSaveDataInfoReaderWithFilter(FsSaveDataInfoReader *reader,
+                                              FsSaveDataSpaceId spaceId,
+                                              const FsSaveDataFilter *filter);
+    Result fsSaveDataInfoReaderRead(FsSaveDataInfoReader *reader, FsSaveDataInfo *buffer, size_t maxEntries, s64 *totalEntries);
+    void fsSaveDataInfoReaderClose(FsSaveDataInfoReader *reader);
+
+    Result fsOpenDeviceOperator(FsDeviceOperator *deviceOperator);
+    Result fsDeviceOperatorIsSdCardInserted(FsDeviceOperator *deviceOperator, bool *out);
+    Result fsDeviceOperatorIsGameCardInserted(FsDeviceOperator *deviceOperator, bool *out);
+    void fsDeviceOperatorClose(FsDeviceOperator *deviceOperator);
+
+    void fsdevUnmountAll(void);
+
+    /// @brief Ticks are nanoseconds on the host.
+    u64 armGetSystemTick(void);
+    u64 armGetSystemTickFreq(void);
+    u64 armTicksToNs(u64 ticks);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,449 @@
+#include "fslib.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <switch.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// @brief Replays a trace recorded with fslib::trace against directories on the host and reports how long each operation
+/// took compared to the trace. Usage: fslib_replay <trace file> <root directory>
+/// @note Each device in the trace is a directory under the root. Ex: sdmc:/JKSV/ is <root>/sdmc/JKSV/. Files the trace reads
+/// but never creates are filled with placeholder data if they don't exist yet, so the same root can be replayed repeatedly.
+
+namespace
+{
+    /// @brief A record and the path that followed it.
+    struct Entry
+    {
+            fslib::trace::Record record{};
+            std::string path{};
+    };
+
+    /// @brief Totals for one operation.
+    struct OperationTotals
+    {
+            uint64_t calls{};
+            uint64_t tracedNanoseconds{};
+            uint64_t replayedNanoseconds{};
+            uint64_t failures{};
+    };
+
+    /// @brief Files and readers opened by the replay, indexed by the handle number in the trace.
+    struct Handles
+    {
+            std::unordered_map<uint32_t, std::unique_ptr<fslib::File>> files{};
+            std::unordered_map<uint32_t, std::unique_ptr<fslib::DirectoryReader>> directories{};
+    };
+
+    /// @brief Size of the chunks placeholder files are written in.
+    constexpr size_t SEED_CHUNK_SIZE = 0x100000;
+} // namespace
+
+// Defined at bottom.
+static bool read_trace(const char *tracePath, std::vector<Entry> &entriesOut);
+static bool is_transfer(fslib::trace::Operation operation);
+static std::string_view get_device(std::string_view path);
+static std::filesystem::path to_host_path(const std::filesystem::path &root, std::string_view path);
+static bool map_devices(const std::vector<Entry> &entries, const std::filesystem::path &root);
+static void seed_files(const std::vector<Entry> &entries, const std::filesystem::path &root);
+static bool replay_entry(const Entry &entry, Handles &handles, std::vector<unsigned char> &buffer);
+static void print_report(const std::array<OperationTotals, fslib::trace::OPERATION_COUNT> &totals,
+                         uint64_t skipped,
+                         uint64_t traceSpan,
+                         uint64_t wallNanoseconds);
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <trace file> <root directory>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Entry> entries{};
+    if (!read_trace(argv[1], entries)) { return 1; }
+
+    const std::filesystem::path root{argv[2]};
+    seed_files(entries, root);
+    if (!map_devices(entries, root)) { return 1; }
+
+    // One buffer big enough for the largest transfer in the trace. Writes just write whatever is in it. Other records use size
+    // for file sizes and such, so a 4GB create file doesn't get a 4GB buffer.
+    int64_t largestTransfer = 1;
+    for (const Entry &entry : entries)
+    {
+        if (is_transfer(entry.record.operation)) { largestTransfer = std::max(largestTransfer, entry.record.size); }
+    }
+    std::vector<unsigned char> buffer(largestTransfer, 0xA5);
+
+    std::array<OperationTotals, fslib::trace::OPERATION_COUNT> totals{};
+    Handles handles{};
+    uint64_t skipped{};
+    uint64_t traceSpan{};
+
+    const auto replayStart = std::chrono::steady_clock::now();
+    for (const Entry &entry : entries)
+    {
+        const fslib::trace::Record &record = entry.record;
+        const bool needsHandle             = record.handle == 0 && (record.operation <= fslib::trace::Operation::CLOSE_DIRECTORY);
+        if (needsHandle)
+        {
+            ++skipped;
+            continue;
+        }
+
+        const auto callStart = std::chrono::steady_clock::now();
+        const bool succeeded = replay_entry(entry, handles, buffer);
+        const auto callEnd   = std::chrono::steady_clock::now();
+
+        OperationTotals &operationTotals = totals[static_cast<size_t>(record.operation)];
+        ++operationTotals.calls;
+        operationTotals.tracedNanoseconds += record.duration;
+        operationTotals.replayedNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(callEnd - callStart).count();
+        if (!succeeded) { ++operationTotals.failures; }
+
+        traceSpan = std::max(traceSpan, record.timestamp + record.duration);
+    }
+    const auto replayEnd = std::chrono::steady_clock::now();
+
+    // Anything the trace left open is closed before the report so it isn't counted.
+    handles.files.clear();
+    handles.directories.clear();
+
+    const uint64_t wallNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(replayEnd - replayStart).count();
+    print_report(totals, skipped, traceSpan, wallNanoseconds);
+    return 0;
+}
+
+static bool read_trace(const char *tracePath, std::vector<Entry> &entriesOut)
+{
+    std::FILE *traceFile = std::fopen(tracePath, "rb");
+    if (!traceFile)
+    {
+        std::fprintf(stderr, "Unable to open %s.\n", tracePath);
+        return false;
+    }
+
+    fslib::trace::Header header{};
+    const bool headerRead = std::fread(&header, sizeof(fslib::trace::Header), 1, traceFile) == 1;
+    if (!headerRead || header.magic != fslib::trace::MAGIC || header.version != fslib::trace::VERSION)
+    {
+        std::fprintf(stderr, "%s isn't a version %u fslib trace.\n", tracePath, fslib::trace::VERSION);
+        std::fclose(traceFile);
+        return false;
+    }
+
+    Entry entry{};
+    while (std::fread(&entry.record, sizeof(fslib::trace::Record), 1, traceFile) == 1)
+    {
+        const bool validOperation = static_cast<size_t>(entry.record.operation) < fslib::trace::OPERATION_COUNT;
+        const bool validSize      = !is_transfer(entry.record.operation) || entry.record.size >= 0;
+        entry.path.resize(entry.record.pathLength);
+        const bool pathRead =
+            entry.record.pathLength == 0 || std::fread(entry.path.data(), entry.record.pathLength, 1, traceFile) == 1;
+        if (!validOperation || !validSize || !pathRead)
+        {
+            std::fprintf(stderr, "%s is truncated or corrupt after %zu records.\n", tracePath, entriesOut.size());
+            break;
+        }
+
+        entriesOut.push_back(entry);
+    }
+
+    std::fclose(traceFile);
+    return true;
+}
+
+static bool is_transfer(fslib::trace::Operation operation)
+{
+    return operation == fslib::trace::Operation::READ || operation == fslib::trace::Operation::WRITE ||
+           operation == fslib::trace::Operation::READ_AT || operation == fslib::trace::Operation::WRITE_AT;
+}
+
+static std::string_view get_device(std::string_view path) { return path.substr(0, path.find_first_of(':')); }
+
+static std::filesystem::path to_host_path(const std::filesystem::path &root, std::string_view path)
+{
+    const size_t colon = path.find_first_of(':');
+    if (colon == path.npos) { return root / path; }
+
+    std::string_view devicePath = path.substr(colon + 1);
+    while (!devicePath.empty() && devicePath.front() == '/') { devicePath.remove_prefix(1); }
+    return root / path.substr(0, colon) / devicePath;
+}
+
+static bool map_devices(const std::vector<Entry> &entries, const std::filesystem::path &root)
+{
+    std::unordered_set<std::string_view> devices{};
+    for (const Entry &entry : entries)
+    {
+        if (!entry.path.empty()) { devices.insert(get_device(entry.path)); }
+    }
+    devices.insert("sdmc");
+
+    std::error_code error{};
+    for (std::string_view device : devices) { std::filesystem::create_directories(root / device, error); }
+
+    // sdmc is opened by fslib itself the first time it's used, so it has to be pointed at the right place first.
+    const std::string sdmcRoot = (root / "sdmc").string();
+    standinSetSdCardRoot(sdmcRoot.c_str());
+    if (!fslib::is_initialized())
+    {
+        std::fprintf(stderr, "Unable to open %s: %s\n", sdmcRoot.c_str(), fslib::error::get_string());
+        return false;
+    }
+
+    for (std::string_view device : devices)
+    {
+        if (device == "sdmc") { continue; }
+
+        FsFileSystem filesystem{};
+        const std::string deviceRoot = (root / device).string();
+        const bool opened            = R_SUCCEEDED(standinOpenDirectoryFileSystem(&filesystem, deviceRoot.c_str()));
+        if (!opened || !fslib::map_file_system(device, filesystem))
+        {
+            std::fprintf(stderr, "Unable to map %s to %s.\n", std::string{device}.c_str(), deviceRoot.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void seed_files(const std::vector<Entry> &entries, const std::filesystem::path &root)
+{
+    // Paths the trace creates on its own don't need to exist beforehand.
+    std::unordered_set<std::string_view> created{};
+    std::unordered_map<std::string_view, int64_t> seedSizes{};
+    std::unordered_map<uint32_t, std::string_view> openPaths{};
+    std::unordered_set<std::string_view> directories{};
+
+    for (const Entry &entry : entries)
+    {
+        const fslib::trace::Record &record = entry.record;
+        const std::string_view path        = entry.path;
+        switch (record.operation)
+        {
+            case fslib::trace::Operation::OPEN_FILE:
+            {
+                const bool creates = (record.flags & FsOpenMode_Create) || created.contains(path);
+                if (!creates) { seedSizes.try_emplace(path, 0); }
+                created.insert(path);
+                openPaths[record.handle] = path;
+            }
+            break;
+
+            case fslib::trace::Operation::READ:
+            case fslib::trace::Operation::READ_AT:
+            case fslib::trace::Operation::GET_BYTE:
+            {
+                const auto findPath = openPaths.find(record.handle);
+                if (findPath == openPaths.end()) { break; }
+
+                const auto findSeed = seedSizes.find(findPath->second);
+                if (findSeed == seedSizes.end()) { break; }
+
+                const int64_t readEnd = record.offset + std::max<int64_t>(record.size, 1);
+                findSeed->second      = std::max(findSeed->second, readEnd);
+            }
+            break;
+
+            case fslib::trace::Operation::OPEN_DIRECTORY:
+            case fslib::trace::Operation::DELETE_DIRECTORY_RECURSIVELY:
+            {
+                if (!created.contains(path)) { directories.insert(path); }
+            }
+            break;
+
+            case fslib::trace::Operation::CREATE_FILE:
+            case fslib::trace::Operation::CREATE_DIRECTORY:
+            {
+                created.insert(path);
+            }
+            break;
+
+            default: break;
+        }
+    }
+
+    std::error_code error{};
+    for (std::string_view directory : directories) { std::filesystem::create_directories(to_host_path(root, directory), error); }
+
+    std::vector<unsigned char> chunk(SEED_CHUNK_SIZE, 0x5A);
+    for (const auto &[path, size] : seedSizes)
+    {
+        const std::filesystem::path hostPath = to_host_path(root, path);
+        if (std::filesystem::exists(hostPath, error)) { continue; }
+
+        std::filesystem::create_directories(hostPath.parent_path(), error);
+        std::FILE *seedFile = std::fopen(hostPath.c_str(), "wb");
+        if (!seedFile) { continue; }
+
+        for (int64_t written = 0; written < size; written += SEED_CHUNK_SIZE)
+        {
+            const size_t writeSize = std::min<int64_t>(SEED_CHUNK_SIZE, size - written);
+            std::fwrite(chunk.data(), 1, writeSize, seedFile);
+        }
+        std::fclose(seedFile);
+    }
+}
+
+static bool replay_entry(const Entry &entry, Handles &handles, std::vector<unsigned char> &buffer)
+{
+    const fslib::trace::Record &record = entry.record;
+    const std::string_view path        = entry.path;
+
+    // Renames carry both paths.
+    const size_t separator          = path.find_first_of(fslib::trace::PATH_SEPARATOR);
+    const fslib::PathView firstPath = path.substr(0, separator);
+    const fslib::PathView newPath   = separator == path.npos ? std::string_view{} : path.substr(separator + 1);
+
+    // Objects are created the first time their handle shows up and reused after that.
+    fslib::File *file{};
+    fslib::DirectoryReader *directory{};
+    if (record.operation <= fslib::trace::Operation::FLUSH)
+    {
+        std::unique_ptr<fslib::File> &handleFile = handles.files[record.handle];
+        if (!handleFile) { handleFile = std::make_unique<fslib::File>(); }
+        file = handleFile.get();
+    }
+    else if (record.operation <= fslib::trace::Operation::CLOSE_DIRECTORY)
+    {
+        std::unique_ptr<fslib::DirectoryReader> &handleDirectory = handles.directories[record.handle];
+        if (!handleDirectory) { handleDirectory = std::make_unique<fslib::DirectoryReader>(); }
+        directory = handleDirectory.get();
+    }
+
+    switch (record.operation)
+    {
+        case fslib::trace::Operation::OPEN_FILE:
+        {
+            file->open(firstPath,
+                       record.flags,
+                       record.offset,
+                       record.size,
+                       static_cast<fslib::File::GrowthPolicy>(record.option));
+            return file->is_open();
+        }
+
+        case fslib::trace::Operation::CLOSE_FILE:
+        {
+            file->close();
+            return true;
+        }
+
+        case fslib::trace::Operation::READ: return file->read(buffer.data(), record.size) >= 0;
+        case fslib::trace::Operation::GET_BYTE: return file->get_byte() >= 0;
+        case fslib::trace::Operation::WRITE: return file->write(buffer.data(), record.size) == record.size;
+        case fslib::trace::Operation::PUT_BYTE: return file->put_byte(static_cast<char>(buffer[0]));
+        case fslib::trace::Operation::READ_AT: return file->read_at(record.offset, buffer.data(), record.size) >= 0;
+        case fslib::trace::Operation::WRITE_AT:
+        {
+            return file->write_at(record.offset, buffer.data(), record.size) == record.size;
+        }
+
+        case fslib::trace::Operation::SEEK:
+        {
+            file->seek(record.offset, static_cast<fslib::Stream::Origin>(record.option));
+            return true;
+        }
+
+        case fslib::trace::Operation::FLUSH: return file->flush();
+
+        case fslib::trace::Operation::OPEN_DIRECTORY:
+        {
+            const fslib::DirectoryFilter filter = {.directories = (record.flags & 1) != 0, .files = (record.flags & 2) != 0};
+            directory->open(firstPath, record.size, filter);
+            return directory->is_open();
+        }
+
+        // Running out of entries is just as valid here as it was when the trace was recorded.
+        case fslib::trace::Operation::READ_DIRECTORY:
+        {
+            directory->read();
+            return true;
+        }
+
+        case fslib::trace::Operation::CLOSE_DIRECTORY:
+        {
+            directory->close();
+            return true;
+        }
+
+        case fslib::trace::Operation::CREATE_FILE: return fslib::create_file(firstPath, record.size);
+        case fslib::trace::Operation::DELETE_FILE: return fslib::delete_file(firstPath);
+        case fslib::trace::Operation::RENAME_FILE: return fslib::rename_file(firstPath, newPath);
+        case fslib::trace::Operation::CREATE_DIRECTORY: return fslib::create_directory(firstPath);
+        case fslib::trace::Operation::DELETE_DIRECTORY: return fslib::delete_directory(firstPath);
+        case fslib::trace::Operation::DELETE_DIRECTORY_RECURSIVELY:
+        {
+            const fslib::DeleteOptions options = {.threadCount = static_cast<int>(record.size), .keepRoot = record.option != 0};
+            return fslib::delete_directory_recursively(firstPath, options);
+        }
+
+        case fslib::trace::Operation::RENAME_DIRECTORY: return fslib::rename_directory(firstPath, newPath);
+        case fslib::trace::Operation::COMMIT: return fslib::commit_data_to_file_system(path);
+    }
+
+    return false;
+}
+
+static void print_report(const std::array<OperationTotals, fslib::trace::OPERATION_COUNT> &totals,
+                         uint64_t skipped,
+                         uint64_t traceSpan,
+                         uint64_t wallNanoseconds)
+{
+    std::printf("%-14s %10s %14s %14s %8s %8s\n", "operation", "calls", "traced ms", "replayed ms", "ratio", "failed");
+
+    OperationTotals sum{};
+    for (size_t i = 0; i < fslib::trace::OPERATION_COUNT; i++)
+    {
+        const OperationTotals &operationTotals = totals[i];
+        if (operationTotals.calls == 0) { continue; }
+
+        const double traced   = static_cast<double>(operationTotals.tracedNanoseconds) / 1000000.0;
+        const double replayed = static_cast<double>(operationTotals.replayedNanoseconds) / 1000000.0;
+        std::printf("%-14s %10llu %14.3f %14.3f %8.2f %8llu\n",
+                    fslib::trace::get_operation_name(static_cast<fslib::trace::Operation>(i)),
+                    static_cast<unsigned long long>(operationTotals.calls),
+                    traced,
+                    replayed,
+                    traced > 0.0 ? replayed / traced : 0.0,
+                    static_cast<unsigned long long>(operationTotals.failures));
+
+        sum.calls += operationTotals.calls;
+        sum.tracedNanoseconds += operationTotals.tracedNanoseconds;
+        sum.replayedNanoseconds += operationTotals.replayedNanoseconds;
+        sum.failures += operationTotals.failures;
+    }
+
+    const double traced   = static_cast<double>(sum.tracedNanoseconds) / 1000000.0;
+    const double replayed = static_cast<double>(sum.replayedNanoseconds) / 1000000.0;
+    std::printf("%-14s %10llu %14.3f %14.3f %8.2f %8llu\n",
+                "total",
+                static_cast<unsigned long long>(sum.calls),
+                traced,
+                replayed,
+                traced > 0.0 ? replayed / traced : 0.0,
+                static_cast<unsigned long long>(sum.failures));
+
+    std::printf("\nTrace span: %.3f ms. Replay wall time: %.3f ms.\n",
+                static_cast<double>(traceSpan) / 1000000.0,
+                static_cast<double>(wallNanoseconds) / 1000000.0);
+
+    // Failures aren't necessarily wrong. The trace doesn't record whether the original call succeeded.
+    if (sum.failures > 0) { std::printf("Calls that failed during replay may have failed when traced too.\n"); }
+    if (skipped > 0)
+    {
+        std::printf("Skipped %llu records for handles opened before tracing began.\n", static_cast<unsigned long long>(skipped));
+    }
+}
@@ -0,0 +1,601 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <switch.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+    /// @brief Result returned when nothing exists at a path.
+    constexpr Result RESULT_PATH_NOT_FOUND = MAKERESULT(Module_Fs, 1);
+
+    /// @brief Result returned when something already exists at a path.
+    constexpr Result RESULT_PATH_ALREADY_EXISTS = MAKERESULT(Module_Fs, 2);
+
+    /// @brief Result returned when writing past the end of a file that wasn't opened with FsOpenMode_Append.
+    constexpr Result RESULT_OUT_OF_RANGE = MAKERESULT(Module_Fs, 6063);
+
+    /// @brief Result returned when deleting a directory that still has a handle open to it.
+    constexpr Result RESULT_TARGET_LOCKED = MAKERESULT(Module_Fs, 7);
+
+    /// @brief Anything else the host reports is returned as this plus errno.
+    constexpr uint32_t HOST_ERROR_BASE = 7000;
+
+    /// @brief Directory fsOpenSdCardFileSystem opens.
+    std::string s_sdCardRoot = "sdmc";
+
+    /// @brief Number of fsFs, fsFile and fsDir calls made so far.
+    std::atomic<u64> s_callCount{};
+
+    /// @brief Microseconds each of those calls sleeps for before doing anything. See standinSetCallLatency.
+    std::atomic<u32> s_callLatency{};
+
+    /// @brief Number of handles open to each directory by device and inode. The host lets open directories be removed, but the
+    /// Switch doesn't, so deleting one of these fails.
+    std::map<std::pair<dev_t, ino_t>, int> s_openDirectories{};
+    std::mutex s_openDirectoryLock{};
+
+    /// @brief Device and inode of the directory standinFailDirectoryReads was pointed at and the number of reads it has left.
+    bool s_failReads{};
+    std::pair<dev_t, ino_t> s_failDirectory{};
+    u32 s_readsBeforeFailure{};
+    std::mutex s_failReadLock{};
+} // namespace
+
+// Defined at bottom.
+static void count_call();
+static Result errno_to_result();
+static const char *relative_path(const char *path);
+static Result clean_directory(FsFileSystem *filesystem, const char *path);
+static Result rename_entry(FsFileSystem *filesystem, const char *oldPath, const char *newPath);
+static bool delete_contents(int directory);
+static bool include_entry(const FsDir *directory, int type);
+static bool directory_is_open(FsFileSystem *filesystem, const char *path);
+static void track_directory(DIR *directory, int change);
+static bool read_should_fail(DIR *directory);
+
+extern "C"
+{
+    void standinSetSdCardRoot(const char *root) { s_sdCardRoot = root; }
+
+    u64 standinGetCallCount(void) { return s_callCount.load(std::memory_order_relaxed); }
+
+    void standinSetCallLatency(u32 microseconds) { s_callLatency.store(microseconds, std::memory_order_relaxed); }
+
+    void standinFailDirectoryReads(const char *hostPath, u32 readsBeforeFailure)
+    {
+        std::lock_guard<std::mutex> failReadGuard{s_failReadLock};
+        struct stat directoryStat{};
+        s_failReads          = hostPath && stat(hostPath, &directoryStat) == 0;
+        s_failDirectory      = {directoryStat.st_dev, directoryStat.st_ino};
+        s_readsBeforeFailure = readsBeforeFailure;
+    }
+
+    Result standinOpenDirectoryFileSystem(FsFileSystem *filesystem, const char *root)
+    {
+        filesystem->root = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (filesystem->root < 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsOpenSdCardFileSystem(FsFileSystem *filesystem)
+    {
+        return standinOpenDirectoryFileSystem(filesystem, s_sdCardRoot.c_str());
+    }
+
+    Result fsFsOpenFile(FsFileSystem *filesystem, const char *path, u32 mode, FsFile *file)
+    {
+        count_call();
+        const int openFlags = (mode & (FsOpenMode_Write | FsOpenMode_Append)) ? O_RDWR : O_RDONLY;
+        file->fd            = openat(filesystem->root, relative_path(path), openFlags | O_CLOEXEC);
+        file->mode          = mode;
+        if (file->fd < 0) { return errno_to_result(); }
+
+        // Directories open fine on the host, but not on the Switch.
+        struct stat fileStat{};
+        if (fstat(file->fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            close(file->fd);
+            file->fd = -1;
+            return RESULT_PATH_NOT_FOUND;
+        }
+        return 0;
+    }
+
+    Result fsFsCreateFile(FsFileSystem *filesystem, const char *path, s64 size, u32 option)
+    {
+        count_call();
+        const int fd = openat(filesystem->root, relative_path(path), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0) { return errno_to_result(); }
+
+        const bool sizeError = size > 0 && ftruncate(fd, size) != 0;
+        const Result result  = sizeError ? errno_to_result() : 0;
+        close(fd);
+        return result;
+    }
+
+    Result fsFsDeleteFile(FsFileSystem *filesystem, const char *path)
+    {
+        count_call();
+        if (unlinkat(filesystem->root, relative_path(path), 0) != 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsFsCreateDirectory(FsFileSystem *filesystem, const char *path)
+    {
+        count_call();
+        if (mkdirat(filesystem->root, relative_path(path), 0755) != 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsFsDeleteDirectory(FsFileSystem *filesystem, const char *path)
+    {
+        count_call();
+        if (directory_is_open(filesystem, path)) { return RESULT_TARGET_LOCKED; }
+        if (unlinkat(filesystem->root, relative_path(path), AT_REMOVEDIR) != 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsFsDeleteDirectoryRecursively(FsFileSystem *filesystem, const char *path)
+    {
+        count_call();
+        if (directory_is_open(filesystem, path)) { return RESULT_TARGET_LOCKED; }
+
+        const Result cleanResult = clean_directory(filesystem, path);
+        if (R_FAILED(cleanResult)) { return cleanResult; }
+
+        if (unlinkat(filesystem->root, relative_path(path), AT_REMOVEDIR) != 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsFsCleanDirectoryRecursively(FsFileSystem *filesystem, const char *path)
+    {
+        count_call();
+        return clean_directory(filesystem, path);
+    }
+
+    Result fsFsRenameFile(FsFileSystem *filesystem, const char *oldPath, const char *newPath)
+    {
+        count_call();
+        return rename_entry(filesystem, oldPath, newPath);
+    }
+
+    Result fsFsRenameDirectory(FsFileSystem *filesystem, const char *oldPath, const char *newPath)
+    {
+        count_call();
+        return rename_entry(filesystem, oldPath, newPath);
+    }
+
+    Result fsFsGetEntryType(FsFileSystem *filesystem, const char *path, FsDirEntryType *type)
+    {
+        count_call();
+        struct stat entryStat{};
+        if (fstatat(filesystem->root, relative_path(path), &entryStat, 0) != 0) { return errno_to_result(); }
+
+        *type = S_ISDIR(entryStat.st_mode) ? FsDirEntryType_Dir : FsDirEntryType_File;
+        return 0;
+    }
+
+    Result fsFsOpenDirectory(FsFileSystem *filesystem, const char *path, u32 mode, FsDir *directory)
+    {
+        count_call();
+        const int fd = openat(filesystem->root, relative_path(path), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) { return errno_to_result(); }
+
+        directory->dir  = fdopendir(fd);
+        directory->mode = mode;
+        if (!directory->dir)
+        {
+            const Result result = errno_to_result();
+            close(fd);
+            return result;
+        }
+
+        track_directory(directory->dir, 1);
+        return 0;
+    }
+
+    Result fsFsGetFreeSpace(FsFileSystem *filesystem, const char *path, s64 *out)
+    {
+        count_call();
+        struct statvfs spaceStat{};
+        if (fstatvfs(filesystem->root, &spaceStat) != 0) { return errno_to_result(); }
+
+        *out = static_cast<s64>(spaceStat.f_bavail) * spaceStat.f_frsize;
+        return 0;
+    }
+
+    Result fsFsGetTotalSpace(FsFileSystem *filesystem, const char *path, s64 *out)
+    {
+        count_call();
+        struct statvfs spaceStat{};
+        if (fstatvfs(filesystem->root, &spaceStat) != 0) { return errno_to_result(); }
+
+        *out = static_cast<s64>(spaceStat.f_blocks) * spaceStat.f_frsize;
+        return 0;
+    }
+
+    Result fsFsGetFileTimeStampRaw(FsFileSystem *filesystem, const char *path, FsTimeStampRaw *out)
+    {
+        count_call();
+        struct stat entryStat{};
+        if (fstatat(filesystem->root, relative_path(path), &entryStat, 0) != 0) { return errno_to_result(); }
+
+        *out          = {};
+        out->created  = entryStat.st_ctime;
+        out->modified = entryStat.st_mtime;
+        out->accessed = entryStat.st_atime;
+        out->is_valid = 1;
+        return 0;
+    }
+
+    // Writes go straight to the host, so there's nothing to commit or flush.
+    Result fsFsCommit(FsFileSystem *filesystem)
+    {
+        count_call();
+        return 0;
+    }
+
+    void fsFsClose(FsFileSystem *filesystem)
+    {
+        count_call();
+        if (filesystem->root >= 0) { close(filesystem->root); }
+        filesystem->root = -1;
+    }
+
+    Result fsFileRead(FsFile *file, s64 offset, void *buffer, u64 readSize, u32 option, u64 *bytesRead)
+    {
+        count_call();
+        unsigned char *bufferOut = static_cast<unsigned char *>(buffer);
+        u64 totalRead{};
+        while (totalRead < readSize)
+        {
+            const ssize_t readCount = pread(file->fd, bufferOut + totalRead, readSize - totalRead, offset + totalRead);
+            if (readCount < 0 && errno == EINTR) { continue; }
+            if (readCount < 0) { return errno_to_result(); }
+            if (readCount == 0) { break; }
+            totalRead += readCount;
+        }
+
+        *bytesRead = totalRead;
+        return 0;
+    }
+
+    Result fsFileWrite(FsFile *file, s64 offset, const void *buffer, u64 writeSize, u32 option)
+    {
+        count_call();
+        if (!(file->mode & FsOpenMode_Append))
+        {
+            struct stat fileStat{};
+            if (fstat(file->fd, &fileStat) != 0) { return errno_to_result(); }
+            if (offset + static_cast<s64>(writeSize) > fileStat.st_size) { return RESULT_OUT_OF_RANGE; }
+        }
+
+        const unsigned char *bufferIn = static_cast<const unsigned char *>(buffer);
+        u64 totalWritten{};
+        while (totalWritten < writeSize)
+        {
+            const ssize_t writeCount =
+                pwrite(file->fd, bufferIn + totalWritten, writeSize - totalWritten, offset + totalWritten);
+            if (writeCount < 0 && errno == EINTR) { continue; }
+            if (writeCount < 0) { return errno_to_result(); }
+            totalWritten += writeCount;
+        }
+        return 0;
+    }
+
+    Result fsFileFlush(FsFile *file)
+    {
+        count_call();
+        return 0;
+    }
+
+    Result fsFileSetSize(FsFile *file, s64 size)
+    {
+        count_call();
+        if (ftruncate(file->fd, size) != 0) { return errno_to_result(); }
+        return 0;
+    }
+
+    Result fsFileGetSize(FsFile *file, s64 *out)
+    {
+        count_call();
+        struct stat fileStat{};
+        if (fstat(file->fd, &fileStat) != 0) { return errno_to_result(); }
+
+        *out = fileStat.st_size;
+        return 0;
+    }
+
+    void fsFileClose(FsFile *file)
+    {
+        count_call();
+        if (file->fd >= 0) { close(file->fd); }
+        file->fd = -1;
+    }
+
+    Result fsDirRead(FsDir *directory, s64 *totalEntries, size_t maxEntries, FsDirectoryEntry *buffer)
+    {
+        count_call();
+        if (read_should_fail(directory->dir)) { return MAKERESULT(Module_Fs, HOST_ERROR_BASE + EIO); }
+
+        const int fd = dirfd(directory->dir);
+        size_t entryCount{};
+        while (entryCount < maxEntries)
+        {
+            const dirent *entry = readdir(directory->dir);
+            if (!entry) { break; }
+            if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) { continue; }
+
+            struct stat entryStat{};
+            if (fstatat(fd, entry->d_name, &entryStat, 0) != 0) { continue; }
+
+            const int type = S_ISDIR(entryStat.st_mode) ? FsDirEntryType_Dir : FsDirEntryType_File;
+            if (!include_entry(directory, type)) { continue; }
+
+            FsDirectoryEntry &entryOut = buffer[entryCount++];
+            entryOut                   = {};
+            std::strncpy(entryOut.name, entry->d_name, FS_MAX_PATH - 1);
+            entryOut.type = type;
+            if (type == FsDirEntryType_File && !(directory->mode & FsDirOpenMode_NoFileSize))
+            {
+                entryOut.file_size = entryStat.st_size;
+            }
+        }
+
+        *totalEntries = entryCount;
+        return 0;
+    }
+
+    Result fsDirGetEntryCount(FsDir *directory, s64 *count)
+    {
+        count_call();
+        // This is counted from a second handle so it doesn't move the one being read.
+        const int fd = openat(dirfd(directory->dir), ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) { return errno_to_result(); }
+
+        DIR *countDir = fdopendir(fd);
+        if (!countDir)
+        {
+            const Result result = errno_to_result();
+            close(fd);
+            return result;
+        }
+
+        s64 entryCount{};
+        while (const dirent *entry = readdir(countDir))
+        {
+            if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) { continue; }
+
+            struct stat entryStat{};
+            if (fstatat(fd, entry->d_name, &entryStat, 0) != 0) { continue; }
+
+            const int type = S_ISDIR(entryStat.st_mode) ? FsDirEntryType_Dir : FsDirEntryType_File;
+            if (include_entry(directory, type)) { ++entryCount; }
+        }
+        closedir(countDir);
+
+        *count = entryCount;
+        return 0;
+    }
+
+    void fsDirClose(FsDir *directory)
+    {
+        count_call();
+        if (directory->dir)
+        {
+            track_directory(directory->dir, -1);
+            closedir(directory->dir);
+        }
+        directory->dir = nullptr;
+    }
+
+    Result fsStorageRead(FsStorage *storage, s64 offset, void *buffer, u64 size) { return RESULT_NOT_IMPLEMENTED; }
+
+    Result fsStorageGetSize(FsStorage *storage, s64 *out) { return RESULT_NOT_IMPLEMENTED; }
+
+    void fsStorageClose(FsStorage *storage) {}
+
+    Result fsOpenBisStorage(FsStorage *storage, FsBisPartitionId partitionId) { return RESULT_NOT_IMPLEMENTED; }
+
+    Result fsOpenBisFileSystem(FsFileSystem *filesystem, FsBisPartitionId partitionId, const char *path)
+    {
+        return RESULT_NOT_IMPLEMENTED;
+    }
+
+    Result fsOpenSaveDataFileSystem(FsFileSystem *filesystem, FsSaveDataSpaceId spaceId, const FsSaveDataAttribute *attr)
+    {
+        return RESULT_NOT_IMPLEMENTED;
+    }
+
+    Result fsOpenSaveDataFileSystemBySystemSaveDataId(FsFileSystem *filesystem,
+                                                      FsSaveDataSpaceId spaceId,
+                                                      const FsSaveDataAttribute *attr)
+    {
+        return RESULT_NOT_IMPLEMENTED;
+    }
+
+    Result fsOpenSaveDataInfoReader(FsSaveDataInfoReader *reader, FsSaveDataSpaceId spaceId) { return RESULT_NOT_IMPLEMENTED; }
+
+    Result fsOpenSaveDataInfoReaderWithFilter(FsSaveDataInfoReader *reader,
+                                              FsSaveDataSpaceId spaceId,
+                                              const FsSaveDataFilter *filter)
+    {
+        return RESULT_NOT_IMPLEMENTED;
+    }
+
+    Result fsSaveDataInfoReaderRead(FsSaveDataInfoReader *reader, FsSaveDataInfo *buffer, size_t maxEntries, s64 *totalEntries)
+    {
+        return RESULT_NOT_IMPLEMENTED;
+    }
+
+    void fsSaveDataInfoReaderClose(FsSaveDataInfoReader *reader) {}
+
+    Result fsOpenDeviceOperator(FsDeviceOperator *deviceOperator) { return RESULT_NOT_IMPLEMENTED; }
+
+    Result fsDeviceOperatorIsSdCardInserted(FsDeviceOperator *deviceOperator, bool *out) { return RESULT_NOT_IMPLEMENTED; }
+
+    Result fsDeviceOperatorIsGameCardInserted(FsDeviceOperator *deviceOperator, bool *out) { return RESULT_NOT_IMPLEMENTED; }
+
+    void fsDeviceOperatorClose(FsDeviceOperator *deviceOperator) {}
+
+    void fsdevUnmountAll(void) {}
+
+    u64 armGetSystemTick(void)
+    {
+        const auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count();
+    }
+
+    u64 armGetSystemTickFreq(void) { return 1000000000; }
+
+    u64 armTicksToNs(u64 ticks) { return ticks; }
+}
+
+static void count_call()
+{
+    s_callCount.fetch_add(1, std::memory_order_relaxed);
+
+    const u32 latency = s_callLatency.load(std::memory_order_relaxed);
+    if (latency > 0) { std::this_thread::sleep_for(std::chrono::microseconds(latency)); }
+}
+
+static Result errno_to_result()
+{
+    switch (errno)
+    {
+        case ENOENT:
+        case ENOTDIR: return RESULT_PATH_NOT_FOUND;
+        case EEXIST:
+        case ENOTEMPTY: return RESULT_PATH_ALREADY_EXISTS;
+        default: return MAKERESULT(Module_Fs, HOST_ERROR_BASE + errno);
+    }
+}
+
+static const char *relative_path(const char *path)
+{
+    // fslib's paths always start at the root of the device.
+    while (*path == '/') { ++path; }
+    return *path == '\0' ? "." : path;
+}
+
+static Result clean_directory(FsFileSystem *filesystem, const char *path)
+{
+    const int directory = openat(filesystem->root, relative_path(path), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory < 0) { return errno_to_result(); }
+
+    // delete_contents takes ownership of the descriptor.
+    if (!delete_contents(directory)) { return errno_to_result(); }
+    return 0;
+}
+
+static Result rename_entry(FsFileSystem *filesystem, const char *oldPath, const char *newPath)
+{
+    // The host would replace whatever is at the new path. The Switch refuses to.
+    struct stat existing{};
+    if (fstatat(filesystem->root, relative_path(newPath), &existing, AT_SYMLINK_NOFOLLOW) == 0)
+    {
+        return RESULT_PATH_ALREADY_EXISTS;
+    }
+
+    if (renameat(filesystem->root, relative_path(oldPath), filesystem->root, relative_path(newPath)) != 0)
+    {
+        return errno_to_result();
+    }
+    return 0;
+}
+
+static bool delete_contents(int directory)
+{
+    DIR *dir = fdopendir(directory);
+    if (!dir)
+    {
+        close(directory);
+        return false;
+    }
+
+    bool deleted = true;
+    while (const dirent *entry = readdir(dir))
+    {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) { continue; }
+
+        struct stat entryStat{};
+        if (fstatat(directory, entry->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            deleted = false;
+            break;
+        }
+
+        if (S_ISDIR(entryStat.st_mode))
+        {
+            const int child = openat(directory, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (child < 0 || !delete_contents(child) || unlinkat(directory, entry->d_name, AT_REMOVEDIR) != 0)
+            {
+                deleted = false;
+                break;
+            }
+        }
+        else if (unlinkat(directory, entry->d_name, 0) != 0)
+        {
+            deleted = false;
+            break;
+        }
+    }
+
+    // errno needs to survive closedir for the caller.
+    const int error = errno;
+    closedir(dir);
+    errno = error;
+    return deleted;
+}
+
+static bool include_entry(const FsDir *directory, int type)
+{
+    const bool wantDirs  = directory->mode & FsDirOpenMode_ReadDirs;
+    const bool wantFiles = directory->mode & FsDirOpenMode_ReadFiles;
+    return type == FsDirEntryType_Dir ? wantDirs : wantFiles;
+}
+
+static bool directory_is_open(FsFileSystem *filesystem, const char *path)
+{
+    struct stat directoryStat{};
+    if (fstatat(filesystem->root, relative_path(path), &directoryStat, 0) != 0) { return false; }
+
+    std::lock_guard<std::mutex> openGuard{s_openDirectoryLock};
+    return s_openDirectories.contains({directoryStat.st_dev, directoryStat.st_ino});
+}
+
+static void track_directory(DIR *directory, int change)
+{
+    struct stat directoryStat{};
+    if (fstat(dirfd(directory), &directoryStat) != 0) { return; }
+
+    std::lock_guard<std::mutex> openGuard{s_openDirectoryLock};
+    const std::pair<dev_t, ino_t> key{directoryStat.st_dev, directoryStat.st_ino};
+    const int openCount = s_openDirectories[key] += change;
+    if (openCount <= 0) { s_openDirectories.erase(key); }
+}
+
+static bool read_should_fail(DIR *directory)
+{
+    std::lock_guard<std::mutex> failReadGuard{s_failReadLock};
+    if (!s_failReads) { return false; }
+
+    struct stat directoryStat{};
+    const bool matches = fstat(dirfd(directory), &directoryStat) == 0 &&
+                         std::make_pair(directoryStat.st_dev, directoryStat.st_ino) == s_failDirectory;
+    if (!matches) { return false; }
+    if (s_readsBeforeFailure == 0) { return true; }
+
+    --s_readsBeforeFailure;
+    return false;
+}